@@ -7,6 +7,7 @@
 #include "classes/Chess.h"
 #include "classes/Robots.h"
 #include <chrono>
+#include <climits>
 
 // Undefine Robots macros before including AstroBots to avoid conflicts
 #undef MOVE
@@ -38,6 +39,19 @@ namespace ClassGame {
         static auto lastAstroBotsUpdate = std::chrono::steady_clock::now();
         static constexpr double ASTROBOTS_UPDATE_INTERVAL_MS = 1000.0 / 30.0;  // 30 Hz
 
+        // Robots playback: turns are simulated on their own clock, independent
+        // of the frame rate; several may run in one frame and only the final
+        // state is drawn
+        static bool robotsAutoPlay = false;
+        static bool robotsFastForward = false;     // "Run to end" in progress
+        static bool robotsAutoRestart = false;     // start the next match when one ends
+        static int robotsTurnsPerSecond = 10;
+        static double robotsTurnDebt = 0.0;        // turns due but not yet played
+        static int robotsMatchesPlayed = 0;
+        static int robotsMatchesDrawn = 0;
+        static auto lastRobotsUpdate = std::chrono::steady_clock::now();
+        static constexpr double ROBOTS_FRAME_BUDGET_MS = 8.0;  // simulation time per frame when fast-forwarding
+
         //
         // game starting point
         // this is called by the main render loop in main.cpp
@@ -131,6 +145,48 @@ namespace ClassGame {
                         if (ImGui::Button("Advance Turn")) {
                             robotGame->endTurn();
                         }
+                        ImGui::SameLine();
+                        if (ImGui::Button("Run to end")) {
+                            robotsFastForward = true;
+                        }
+                        if (ImGui::Checkbox("Auto-play", &robotsAutoPlay)) {
+                            lastRobotsUpdate = std::chrono::steady_clock::now();
+                            robotsTurnDebt = 0.0;
+                        }
+                        ImGui::SameLine();
+                        ImGui::Checkbox("Auto-restart", &robotsAutoRestart);
+                        ImGui::SliderInt("Turns/sec", &robotsTurnsPerSecond, 1, 1000, "%d", ImGuiSliderFlags_Logarithmic);
+                        if (robotsMatchesPlayed > 0) {
+                            ImGui::Text("Matches: %d (%d drawn)", robotsMatchesPlayed, robotsMatchesDrawn);
+                        }
+
+                        auto now = std::chrono::steady_clock::now();
+                        double elapsedMs = std::chrono::duration<double, std::milli>(now - lastRobotsUpdate).count();
+                        lastRobotsUpdate = now;
+                        if (robotsFastForward) {
+                            // As many turns as fit in the frame budget; the rest next frame
+                            robotGame->advanceTurns(INT_MAX, ROBOTS_FRAME_BUDGET_MS);
+                            // a batch keeps fast-forwarding into the next match
+                            if (!robotGame->isRunning() && !robotsAutoRestart) robotsFastForward = false;
+                        } else if (robotsAutoPlay && robotGame->isRunning()) {
+                            robotsTurnDebt += elapsedMs * robotsTurnsPerSecond / 1000.0;
+                            int due = (int)robotsTurnDebt;
+                            if (due > 0) {
+                                int played = robotGame->advanceTurns(due, ROBOTS_FRAME_BUDGET_MS);
+                                // a slow machine drops turns rather than falling ever further behind
+                                robotsTurnDebt = played < due ? 0.0 : robotsTurnDebt - due;
+                            }
+                        }
+
+                        // Unattended batches: count the result and deal the next match
+                        if (robotsAutoRestart && !robotGame->isRunning()) {
+                            robotsMatchesPlayed++;
+                            if (!gameOver || gameWinner < 0) robotsMatchesDrawn++;
+                            game->stopGame();
+                            game->setUpBoard();
+                            gameOver = false;
+                            gameWinner = -1;
+                        }
                     } else if (astroGame) {
                         auto now = std::chrono::steady_clock::now();
                         double elapsedMs = std::chrono::duration<double, std::milli>(now - lastAstroBotsUpdate).count();
@@ -0,0 +1,253 @@
+#include "RobotsAnalytics.h"
+#include <cstring>
+
+static const char STATS_MAGIC[4] = {'R', 'B', 'S', 'T'};
+static constexpr uint32_t STATS_VERSION = 1;
+static constexpr size_t MAX_QUEUED_CHUNKS = 4;
+
+const char* RobotsStatColumnName(int column)
+{
+    static const char* const names[] = {
+        "seed", "seat", "name", "bots", "turns", "result",
+        "damage_dealt", "damage_taken", "shots_fired", "shots_missed", "kills",
+        "tiles_moved", "turns_survived", "signals", "hp_left",
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == STAT_COLUMN_COUNT, "column names out of sync");
+    return column >= 0 && column < STAT_COLUMN_COUNT ? names[column] : "?";
+}
+
+static int columnWidth(int column) { return column == STAT_SEED ? 8 : 4; }
+
+// ===== byte encoding =====
+static void putU32(std::vector<uint8_t> &out, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+static uint64_t getLE(const uint8_t *p, int width)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < width; ++i) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+// ===== RobotsAnalyticsWriter =====
+bool RobotsAnalyticsWriter::Open(const std::string &path, std::string *error, int chunkRows)
+{
+    Close();
+    _file = fopen(path.c_str(), "wb");
+    if (!_file) {
+        if (error) *error = "cannot write " + path;
+        return false;
+    }
+    std::vector<uint8_t> header(STATS_MAGIC, STATS_MAGIC + 4);
+    putU32(header, STATS_VERSION);
+    putU32(header, STAT_COLUMN_COUNT);
+    for (int c = 0; c < STAT_COLUMN_COUNT; ++c) {
+        const char *name = RobotsStatColumnName(c);
+        header.push_back((uint8_t)columnWidth(c));
+        header.push_back((uint8_t)strlen(name));
+        header.insert(header.end(), name, name + strlen(name));
+    }
+    _failed = fwrite(header.data(), 1, header.size(), _file) != header.size();
+
+    _chunkRows = std::max(chunkRows, 1);
+    _current.reset(new Chunk());
+    _names.clear();
+    _rows = 0;
+    _stop = false;
+    _writer = std::thread(&RobotsAnalyticsWriter::writerLoop, this);
+    return true;
+}
+
+void RobotsAnalyticsWriter::Append(const RobotsMatch &match, const RobotsMatchStats &stats)
+{
+    const Arena &A = match.arena;
+    int winner = match.Winner();
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_file) return;
+    for (size_t i = 0; i < A.bots.size(); ++i) {
+        const Arena::BotState &b = A.bots[i];
+        const RobotsBotStats s = i < stats.bots.size() ? stats.bots[i] : RobotsBotStats();
+        const std::string &name = match.bots[i]->name;
+        auto known = _names.find(name);
+        int nameId;
+        if (known == _names.end()) {
+            nameId = (int)_names.size();
+            _names.emplace(name, nameId);
+            _current->newNames.push_back(name);
+        } else {
+            nameId = known->second;
+        }
+        int result = winner == (int)i ? 1 : (winner == -1 && b.alive ? 0 : -1);
+
+        const int64_t row[STAT_COLUMN_COUNT] = {
+            (int64_t)match.seed, (int64_t)i, nameId, (int64_t)A.bots.size(), match.TurnsPlayed(), result,
+            s.damageDealt, s.damageTaken, s.shotsFired, s.shotsMissed, s.kills,
+            s.tilesMoved, b.turns_run, s.signals, b.alive ? b.hp : 0,
+        };
+        RobotsStatChunk &chunk = _current->data;
+        for (int c = 0; c < STAT_COLUMN_COUNT; ++c) chunk.columns[c].push_back(row[c]);
+        chunk.rows++;
+        _rows++;
+
+        if (chunk.rows >= _chunkRows) {
+            _space.wait(lock, [&] { return _queue.size() < MAX_QUEUED_CHUNKS; });
+            _queue.push_back(std::move(_current));
+            _current.reset(new Chunk());
+            _ready.notify_one();
+        }
+    }
+}
+
+bool RobotsAnalyticsWriter::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_file) return true;
+        if (_current && _current->data.rows > 0) _queue.push_back(std::move(_current));
+        _stop = true;
+    }
+    _ready.notify_one();
+    _writer.join();
+
+    bool ok = !_failed && fclose(_file) == 0;
+    _file = nullptr;
+    _current.reset();
+    return ok;
+}
+
+void RobotsAnalyticsWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _ready.wait(lock, [&] { return _stop || !_queue.empty(); });
+        if (_queue.empty()) return;     // stopping and drained
+        std::unique_ptr<Chunk> chunk = std::move(_queue.front());
+        _queue.pop_front();
+        _space.notify_all();
+        lock.unlock();
+        bool ok = writeChunk(*chunk);
+        lock.lock();
+        if (!ok) _failed = true;
+    }
+}
+
+bool RobotsAnalyticsWriter::writeChunk(const Chunk &chunk)
+{
+    const RobotsStatChunk &data = chunk.data;
+    std::vector<uint8_t> out;
+    putU32(out, (uint32_t)data.rows);
+    putU32(out, (uint32_t)chunk.newNames.size());
+    for (const std::string &name : chunk.newNames) {
+        size_t len = std::min(name.size(), (size_t)0xffff);
+        out.push_back((uint8_t)len);
+        out.push_back((uint8_t)(len >> 8));
+        out.insert(out.end(), name.begin(), name.begin() + len);
+    }
+    for (int c = 0; c < STAT_COLUMN_COUNT; ++c) {
+        int width = columnWidth(c);
+        size_t at = out.size();
+        out.resize(at + (size_t)data.rows * width);
+        uint8_t *p = out.data() + at;
+        for (int64_t v : data.columns[c]) {
+            for (int i = 0; i < width; ++i) *p++ = (uint8_t)((uint64_t)v >> (8 * i));
+        }
+    }
+    return fwrite(out.data(), 1, out.size(), _file) == out.size();
+}
+
+// ===== RobotsAnalyticsReader =====
+bool RobotsAnalyticsReader::Open(const std::string &path, std::string *error)
+{
+    auto fail = [&](const std::string &why) {
+        if (error) *error = why;
+        if (_file) fclose(_file);
+        _file = nullptr;
+        return false;
+    };
+    if (_file) fclose(_file);
+    _names.clear();
+    _error.clear();
+    _file = fopen(path.c_str(), "rb");
+    if (!_file) return fail("cannot read " + path);
+    if (fseek(_file, 0, SEEK_END) != 0) return fail("cannot read " + path);
+    long size = ftell(_file);
+    if (size < 0 || fseek(_file, 0, SEEK_SET) != 0) return fail("cannot read " + path);
+    _fileSize = (uint64_t)size;
+
+    uint8_t head[12];
+    if (fread(head, 1, sizeof(head), _file) != sizeof(head) || memcmp(head, STATS_MAGIC, 4) != 0) {
+        return fail("not a Robots analytics file");
+    }
+    if (getLE(head + 4, 4) != STATS_VERSION) return fail("unsupported analytics version");
+    uint32_t columns = (uint32_t)getLE(head + 8, 4);
+    if (columns != STAT_COLUMN_COUNT) return fail("unexpected analytics columns");
+    for (uint32_t c = 0; c < columns; ++c) {
+        uint8_t meta[2];
+        char name[256];
+        if (fread(meta, 1, 2, _file) != 2 || fread(name, 1, meta[1], _file) != meta[1]) return fail("corrupt analytics header");
+        if (meta[0] != columnWidth((int)c) || std::string(name, meta[1]) != RobotsStatColumnName((int)c)) {
+            return fail("unexpected analytics columns");
+        }
+        _widths[c] = meta[0];
+    }
+    return true;
+}
+
+bool RobotsAnalyticsReader::Next(RobotsStatChunk &chunk, uint32_t mask)
+{
+    if (!_file) return false;
+    uint8_t head[8];
+    size_t got = fread(head, 1, sizeof(head), _file);
+    if (got == 0 && feof(_file)) return false;
+    if (got != sizeof(head)) {
+        _error = "truncated chunk";
+        return false;
+    }
+    uint32_t rows = (uint32_t)getLE(head, 4);
+    uint32_t newNames = (uint32_t)getLE(head + 4, 4);
+    for (uint32_t i = 0; i < newNames; ++i) {
+        uint8_t len[2];
+        if (fread(len, 1, 2, _file) != 2) { _error = "truncated chunk"; return false; }
+        std::string name((size_t)getLE(len, 2), '\0');
+        if (!name.empty() && fread(&name[0], 1, name.size(), _file) != name.size()) { _error = "truncated chunk"; return false; }
+        _names.push_back(name);
+    }
+
+    // check the row count against the bytes left before sizing anything by it
+    uint64_t rowBytes = 0;
+    for (int c = 0; c < STAT_COLUMN_COUNT; ++c) rowBytes += (uint64_t)_widths[c];
+    long at = ftell(_file);
+    if (at < 0 || (uint64_t)rows * rowBytes > _fileSize - std::min(_fileSize, (uint64_t)at)) {
+        _error = "truncated chunk";
+        return false;
+    }
+
+    chunk.rows = (int)rows;
+    for (int c = 0; c < STAT_COLUMN_COUNT; ++c) {
+        size_t bytes = (size_t)rows * _widths[c];
+        std::vector<int64_t> &column = chunk.columns[c];
+        column.clear();
+        if (!(mask & (1u << c))) {
+            if (fseek(_file, (long)bytes, SEEK_CUR) != 0) { _error = "truncated chunk"; return false; }
+            continue;
+        }
+        _buffer.resize(bytes);
+        if (fread(_buffer.data(), 1, bytes, _file) != bytes) { _error = "truncated chunk"; return false; }
+        column.resize(rows);
+        const uint8_t *p = _buffer.data();
+        int width = _widths[c];
+        for (uint32_t r = 0; r < rows; ++r, p += width) {
+            uint64_t v = getLE(p, width);
+            // 4-byte columns hold signed 32-bit values
+            column[r] = width == 4 ? (int64_t)(int32_t)(uint32_t)v : (int64_t)v;
+        }
+        if (c == STAT_NAME) {
+            for (int64_t name : column) {
+                if (name < 0 || name >= (int64_t)_names.size()) { _error = "name outside the dictionary"; return false; }
+            }
+        }
+    }
+    return true;
+}
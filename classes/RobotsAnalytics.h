@@ -0,0 +1,115 @@
+#pragma once
+
+#include "RobotsMatch.h"
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ===== Match analytics =====
+// Per-bot match statistics (RobotsMatchStats plus the outcome) stored by
+// column, so a pass over millions of matches reads only the columns it asks
+// for, straight into arrays, with no text to parse.
+//
+// One row per bot per match. Rows are grouped into chunks; a chunk stores
+// each column contiguously, so any column can be skipped with one seek.
+//
+// File layout (all integers little-endian):
+//   "RBST" u32 version, u32 columns, per column: u8 width (4 or 8),
+//   u8 name length + name
+//   then chunks until the end of the file:
+//   u32 rows, u32 new bot names (u16 length + bytes each, appended to the
+//   name dictionary STAT_NAME indexes), then every column in order,
+//   rows x width bytes.
+enum RobotsStatColumn {
+    STAT_SEED,              // match seed (u64)
+    STAT_SEAT,              // bot index in the match
+    STAT_NAME,              // index into the file's name dictionary
+    STAT_BOTS,              // bots in the match
+    STAT_TURNS,             // turns the match lasted
+    STAT_RESULT,            // 1 win, 0 draw (standing at the turn limit), -1 loss
+    STAT_DAMAGE_DEALT,
+    STAT_DAMAGE_TAKEN,
+    STAT_SHOTS_FIRED,
+    STAT_SHOTS_MISSED,
+    STAT_KILLS,
+    STAT_TILES_MOVED,
+    STAT_TURNS_SURVIVED,    // turns the bot got to run
+    STAT_SIGNALS,
+    STAT_HP_LEFT,
+    STAT_COLUMN_COUNT
+};
+
+const char* RobotsStatColumnName(int column);   // "seed", "damage_dealt", ...
+
+struct RobotsStatChunk {
+    int rows = 0;
+    std::array<std::vector<int64_t>, STAT_COLUMN_COUNT> columns;   // only the columns that were read
+};
+
+// Appends rows from any number of threads; a background thread encodes and
+// writes each full chunk, so callers only copy a few ints under a lock.
+// Append blocks while several chunks are waiting for the disk.
+class RobotsAnalyticsWriter
+{
+public:
+    ~RobotsAnalyticsWriter() { Close(); }
+
+    bool Open(const std::string &path, std::string *error = nullptr, int chunkRows = 65536);
+    // one row per bot; `stats` must have been attached while the match played
+    void Append(const RobotsMatch &match, const RobotsMatchStats &stats);
+    // write the last partial chunk and stop the writer; false if any write failed
+    bool Close();
+
+    bool IsOpen() const { return _file != nullptr; }
+    uint64_t Rows() const { return _rows; }
+
+private:
+    struct Chunk {
+        RobotsStatChunk data;
+        std::vector<std::string> newNames;
+    };
+    void writerLoop();
+    bool writeChunk(const Chunk &chunk);
+
+    FILE *_file = nullptr;
+    int _chunkRows = 65536;
+    std::mutex _mutex;
+    std::condition_variable _ready, _space;
+    std::unique_ptr<Chunk> _current;
+    std::deque<std::unique_ptr<Chunk>> _queue;
+    std::map<std::string, int> _names;
+    uint64_t _rows = 0;
+    bool _stop = false;
+    bool _failed = false;
+    std::thread _writer;
+};
+
+class RobotsAnalyticsReader
+{
+public:
+    ~RobotsAnalyticsReader() { if (_file) fclose(_file); }
+
+    bool Open(const std::string &path, std::string *error = nullptr);
+    // the next chunk with the columns in `mask` (bit per RobotsStatColumn);
+    // false at the end of the file or on a truncated or corrupt chunk (see Error())
+    bool Next(RobotsStatChunk &chunk, uint32_t mask = ~0u);
+
+    const std::vector<std::string> &Names() const { return _names; }   // dictionary so far
+    const std::string &Error() const { return _error; }
+
+private:
+    FILE *_file = nullptr;
+    uint64_t _fileSize = 0;     // a chunk can claim no more rows than fit in what is left
+    std::array<int, STAT_COLUMN_COUNT> _widths{};
+    std::vector<std::string> _names;
+    std::vector<uint8_t> _buffer;
+    std::string _error;
+};
@@ -0,0 +1,563 @@
+#include "RobotsArena.h"
+#include <cmath>
+#include <random>
+
+// ===== RobotsRng =====
+static uint64_t splitmix64(uint64_t &x){
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void RobotsRng::Seed(uint64_t seed){
+    // scramble so consecutive match seeds give unrelated streams
+    state = splitmix64(seed);
+    inc = splitmix64(seed) | 1;
+    Next();
+}
+
+uint32_t RobotsRng::Next(){
+    uint64_t old = state;
+    state = old * 6364136223846793005ULL + inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+int RobotsRng::Range(int lo, int hi){
+    uint32_t span = (uint32_t)(hi - lo) + 1u;
+    if (span == 0) return (int)Next();
+    // reject the uneven tail so every value is equally likely
+    uint32_t limit = (uint32_t)(-span) % span;
+    uint32_t r;
+    do { r = Next(); } while (r < limit);
+    return lo + (int)(r % span);
+}
+
+uint64_t RandomSeed(){
+    std::random_device rd;
+    return ((uint64_t)rd() << 32) ^ rd();
+}
+
+// ===== Arena mechanics =====
+bool Arena::EnemyAdjacent(int self, int dir){
+    auto &b = bots[self]; int nx=b.x+dx[dir], ny=b.y+dy[dir];
+    int t = BotAt(nx,ny);
+    return t!=-1 && t!=self;
+}
+
+int Arena::BotAt(int x,int y){
+    if(!InBounds(x,y)) return -1;
+    return occupancy[Cell(x,y)];
+}
+
+void Arena::RebuildOccupancy(){
+    occupancy.assign((size_t)cfg.width*cfg.height, -1);
+    posX.assign(bots.size(), SCAN_FAR);
+    posY.assign(bots.size(), SCAN_FAR);
+    for (int i=0;i<(int)bots.size();++i){
+        auto&o=bots[i];
+        if(!o.alive) continue;
+        posX[i]=o.x; posY[i]=o.y;
+        if(!InBounds(o.x,o.y)) continue;
+        int &cell = occupancy[Cell(o.x,o.y)];
+        if(cell==-1) cell=i;    // lowest index wins if two bots were stacked
+    }
+    posEpoch++;
+    if(dirty) dirty->MarkAll((int)bots.size());
+
+    signalCols = (cfg.width + SIGNAL_BUCKET - 1) / SIGNAL_BUCKET;
+    signalRows = (cfg.height + SIGNAL_BUCKET - 1) / SIGNAL_BUCKET;
+    signalHead.assign((size_t)signalCols*signalRows, -1);
+    signalStamp.assign((size_t)signalCols*signalRows, 0);
+    signalEpoch = 1;
+    signalNext.clear();
+    for (int s=0;s<(int)signals.size();++s) indexSignal(s);
+}
+
+void Arena::botMoved(int self, int nx, int ny){
+    auto &b=bots[self];
+    int &from = occupancy[Cell(b.x,b.y)];
+    if(from==self) from=-1;
+    b.x=nx; b.y=ny;
+    occupancy[Cell(nx,ny)]=self;
+    posX[self]=nx; posY[self]=ny;
+    posEpoch++;
+    if(dirty) dirty->Mark(self);
+}
+
+void Arena::botDied(int t){
+    auto &o=bots[t];
+    o.alive=false;
+    int &cell = occupancy[Cell(o.x,o.y)];
+    if(cell==t) cell=-1;
+    posX[t]=SCAN_FAR; posY[t]=SCAN_FAR;
+    posEpoch++;
+    if(dirty) dirty->Mark(t);
+}
+
+bool Arena::InBounds(int x,int y){
+    return !(x<0||y<0||x>=cfg.width||y>=cfg.height);
+}
+
+void Arena::Move(int self,int dist){
+    auto &b=bots[self];
+    if(planning){
+        // walk the turn-start board; the move itself happens in ResolveTurn
+        auto &in=intents[self];
+        while(dist--){
+            int nx=in.toX+dx[b.dir], ny=in.toY+dy[b.dir];
+            if(!InBounds(nx,ny)) break;
+            int t=occupancy[Cell(nx,ny)];
+            if(t!=-1 && t!=self) break;
+            in.toX=nx; in.toY=ny;
+        }
+        return;
+    }
+    int startX = b.x, startY = b.y;
+    while(dist-- && b.alive){
+        int nx=b.x+dx[b.dir], ny=b.y+dy[b.dir];
+        if(!InBounds(nx,ny)) break; // wall
+        if(BotAt(nx,ny)!=-1) break;        // blocked by bot
+        botMoved(self,nx,ny);
+    }
+    if (b.x != startX || b.y != startY) {
+        emit(EV_MOVE, self, -1, Cell(b.x,b.y), std::max(std::abs(b.x-startX), std::abs(b.y-startY)));
+    }
+}
+
+void Arena::Turn(int self,int d){
+    bots[self].dir = d;
+}
+
+void Arena::Attack(int self,int d){
+    auto &b=bots[self];
+    if(b.cooldown>0) return;
+    if(planning){
+        intents[self].attacks.push_back(d);
+        b.cooldown = cfg.attackCooldown;
+        return;
+    }
+    int x=b.x, y=b.y;
+    for(int step=1; step<=cfg.attackRange; ++step){
+        x += dx[d]; y += dy[d];
+        if(!InBounds(x,y)) break;
+        int t = BotAt(x,y);
+        if(t!=-1){
+            bots[t].hp--;
+            emit(EV_HIT, self, t, Cell(x,y), bots[t].hp);
+            if(bots[t].hp<=0){ botDied(t); }
+            if (!bots[t].alive) {
+                emit(EV_DESTROYED, self, t, Cell(x,y), 0);
+            }
+            b.cooldown = cfg.attackCooldown;
+            return;
+        }
+    }
+    // even a miss incurs cooldown
+    b.cooldown = cfg.attackCooldown;
+    emit(EV_MISS, self, -1, Cell(b.x,b.y), d);
+}
+
+void Arena::AttackScan(int self){
+    auto &b=bots[self];
+    if(b.scan_dir>=0) Attack(self, b.scan_dir);
+}
+
+ScanHit Arena::scanFrom(int self){
+    auto &b=bots[self];
+    int n=(int)bots.size();
+    // once the scan window holds fewer cells than there are bots, walking
+    // rings of the occupancy grid beats a pass over every bot
+    long long window = (2LL*cfg.scanRange+1)*(2LL*cfg.scanRange+1);
+    if (window < n && InBounds(b.x,b.y)) {
+        return ScanNearestGrid(occupancy.data(), cfg.width, cfg.height, b.x, b.y, cfg.scanRange);
+    }
+    return ScanNearestSimd(posX.data(), posY.data(), n, b.x, b.y, cfg.scanRange);
+}
+
+void Arena::Scan(int self){
+    auto &b=bots[self];
+    // Radial scan: find nearest alive enemy within Chebyshev distance
+    ScanHit hit = (batchScan && scanBatchEpoch==posEpoch) ? scanBatch[self] : scanFrom(self);
+    b.scan_dist = hit.dist;
+    b.scan_dir  = hit.index>=0 ? ScanDirection(posX[hit.index]-b.x, posY[hit.index]-b.y) : -1;
+}
+
+void Arena::ScanAll(){
+    scanBatch.assign(bots.size(), ScanHit());
+    for (int i=0;i<(int)bots.size();++i){
+        if(bots[i].alive) scanBatch[i]=scanFrom(i);
+    }
+    scanBatchEpoch=posEpoch;
+}
+
+void Arena::Signal(int self, int value){
+    auto &b=bots[self];
+    b.signal = value;
+    if(planning){ intents[self].signals.push_back(value); return; }
+    signals.emplace_back(b.x, b.y);
+    indexSignal((int)signals.size()-1);
+    emit(EV_SIGNAL, self, -1, Cell(b.x,b.y), value);
+}
+
+void Arena::indexSignal(int s){
+    const auto &p=signals[s];
+    int bucket = (p.second/SIGNAL_BUCKET)*signalCols + p.first/SIGNAL_BUCKET;
+    if(signalStamp[bucket]!=signalEpoch){
+        signalStamp[bucket]=signalEpoch;
+        signalHead[bucket]=-1;
+    }
+    signalNext.push_back(signalHead[bucket]);
+    signalHead[bucket]=s;
+}
+
+void Arena::ClearSignals(){
+    signals.clear();
+    signalNext.clear();
+    signalEpoch++;
+}
+
+bool Arena::HasSignalNearby(int self, int radius){
+    if(signals.empty() || radius<0) return false;
+    auto &b=bots[self];
+    // signals are always on the board, so clamp the query window to it
+    int x0=std::max(b.x-radius,0), x1=std::min(b.x+radius,cfg.width-1);
+    int y0=std::max(b.y-radius,0), y1=std::min(b.y+radius,cfg.height-1);
+    if(x0>x1 || y0>y1) return false;
+    int bx0=x0/SIGNAL_BUCKET, bx1=x1/SIGNAL_BUCKET;
+    int by0=y0/SIGNAL_BUCKET, by1=y1/SIGNAL_BUCKET;
+
+    // a huge radius with few signals: the plain walk is cheaper
+    if((size_t)(bx1-bx0+1)*(by1-by0+1) > signals.size()){
+        for(auto &p: signals){
+            if(p.first>=x0 && p.first<=x1 && p.second>=y0 && p.second<=y1) return true;
+        }
+        return false;
+    }
+
+    for(int by=by0; by<=by1; ++by){
+        bool rowsInside = by*SIGNAL_BUCKET>=y0 && by*SIGNAL_BUCKET+SIGNAL_BUCKET-1<=y1;
+        for(int bx=bx0; bx<=bx1; ++bx){
+            int bucket = by*signalCols+bx;
+            if(signalStamp[bucket]!=signalEpoch) continue;
+            int s = signalHead[bucket];
+            // bucket entirely inside the window: any signal in it counts
+            if(rowsInside && bx*SIGNAL_BUCKET>=x0 && bx*SIGNAL_BUCKET+SIGNAL_BUCKET-1<=x1) return true;
+            for(; s>=0; s=signalNext[s]){
+                const auto &p=signals[s];
+                if(p.first>=x0 && p.first<=x1 && p.second>=y0 && p.second<=y1) return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Arena::EndBotTurn(int self, int cycles, bool outOfCycles){
+    auto &b=bots[self];
+    b.cycles = cycles;
+    b.max_cycles = std::max(b.max_cycles, cycles);
+    b.total_cycles += cycles;
+    b.turns_run++;
+    if(!outOfCycles) return;
+    b.cycle_outs++;
+    if(planning){ intents[self].outOfCycles=true; intents[self].cycles=cycles; return; }
+    emit(EV_OUT_OF_CYCLES, self, -1, Cell(b.x,b.y), cycles);
+}
+
+void Arena::StartTurn(){
+    // simultaneous turns publish signals in ResolveTurn; they stay visible
+    // through the next turn's planning
+    if(!cfg.simultaneous) ClearSignals();
+    if(batchScan) ScanAll();
+    flowTurn++;
+    for(auto &bs : bots){
+        if(!bs.alive) continue;
+        // track whether bot was damaged since previous turn
+        bs.damaged_last_turn = (bs.hp < bs.last_hp);
+        bs.last_hp = bs.hp;
+        if(bs.cooldown>0) --bs.cooldown;
+        bs.signal = -1;
+    }
+}
+
+int Arena::RandomDirection(int self){
+    return planning ? intents[self].rng.Range(0,7) : rng.Range(0,7);
+}
+
+// ===== Flow fields =====
+bool Arena::flowFresh(int target) const{
+    const FlowField &f=flow[target];
+    if(!f.built || f.posEpoch!=posEpoch || f.dist.size()!=occupancy.size()) return false;
+    return target!=TOWARD_SIGNAL || (f.signalEpoch==signalEpoch && f.signalCount==signals.size());
+}
+
+// Multi-source BFS over free cells, 8-way. The enemy field lets each cell be
+// reached twice, by goals of two different bots, so a bot can look past
+// itself: the second visit of a cell fills dist2.
+void Arena::buildFlow(int target){
+    FlowField &f=flow[target];
+    const int W=cfg.width, H=cfg.height;
+    const size_t cells=(size_t)W*H;
+    const bool enemy = target==TOWARD_ENEMY;
+    f.dist.assign(cells, FLOW_FAR);
+    if(enemy){ f.owner.assign(cells, -1); f.dist2.assign(cells, FLOW_FAR); }
+    else { f.owner.clear(); f.dist2.clear(); }
+    flowQueue.clear();
+    auto seed=[&](int x, int y, int owner){
+        if(!InBounds(x,y)) return;
+        int cell=Cell(x,y);
+        if(f.dist[cell]==0) return;
+        f.dist[cell]=0;
+        if(enemy) f.owner[cell]=owner;
+        flowQueue.push_back(FlowVisit{cell, owner, 0});
+    };
+    if(target==TOWARD_ENEMY){
+        for(int i=0;i<(int)bots.size();++i){
+            if(bots[i].alive && InBounds(bots[i].x,bots[i].y) && occupancy[Cell(bots[i].x,bots[i].y)]==i) seed(bots[i].x, bots[i].y, i);
+        }
+    } else if(target==TOWARD_SIGNAL){
+        for(auto &p: signals) seed(p.first, p.second, -1);
+    } else {
+        for(int y=(H-1)/2; y<=H/2; ++y) for(int x=(W-1)/2; x<=W/2; ++x) seed(x, y, -1);
+    }
+
+    for(size_t head=0; head<flowQueue.size(); ++head){
+        const FlowVisit v=flowQueue[head];
+        int x=v.cell%W, y=v.cell/W;
+        for(int d=0; d<8; ++d){
+            int nx=x+dx[d], ny=y+dy[d];
+            if(!InBounds(nx,ny)) continue;
+            int n=Cell(nx,ny);
+            if(occupancy[n]!=-1) continue;
+            if(f.dist[n]==FLOW_FAR){
+                f.dist[n]=v.dist+1;
+                if(enemy) f.owner[n]=v.owner;
+            } else if(enemy && f.dist2[n]==FLOW_FAR && f.owner[n]!=v.owner){
+                f.dist2[n]=v.dist+1;
+            } else continue;
+            flowQueue.push_back(FlowVisit{n, v.owner, v.dist+1});
+        }
+    }
+
+    f.built=true;
+    f.posEpoch=posEpoch;
+    f.signalEpoch=signalEpoch;
+    f.signalCount=signals.size();
+}
+
+const Arena::FlowField *Arena::flowField(int target){
+    if(target<0 || target>=FLOW_TARGET_COUNT) return nullptr;
+    FlowField &f=flow[target];
+    // planning bots may run on several threads: only read what BeginPlanning built
+    if(planning) return f.checkedTurn==flowTurn && flowFresh(target) ? &f : nullptr;
+    if(f.checkedTurn!=flowTurn || !f.built){
+        f.checkedTurn=flowTurn;
+        if(!flowFresh(target)) buildFlow(target);
+    }
+    return &f;
+}
+
+int Arena::FlowSteps(int target, int x, int y, int self){
+    const FlowField *f=flowField(target);
+    if(!f || !InBounds(x,y)) return FLOW_FAR;
+    return f->Steps(Cell(x,y), self);
+}
+
+void Arena::MoveToward(int self, int target){
+    const FlowField *f=flowField(target);
+    if(!f) return;
+    auto &b=bots[self];
+    int x=planning ? intents[self].toX : b.x;
+    int y=planning ? intents[self].toY : b.y;
+    int best=-1, bestSteps=f->Steps(Cell(x,y), self);
+    for(int k=0; k<8; ++k){
+        int d=(b.dir+k)%8;
+        int nx=x+dx[d], ny=y+dy[d];
+        if(!InBounds(nx,ny)) continue;
+        int steps=f->Steps(Cell(nx,ny), self);
+        if(steps<bestSteps){ best=d; bestSteps=steps; }
+    }
+    if(best<0) return;
+    Turn(self, best);
+    Move(self, 1);
+}
+
+// ===== Simultaneous turns =====
+void Arena::BeginPlanning(){
+    // one draw from the arena stream per turn seeds every bot's own stream,
+    // so TURN_RANDOM does not depend on which thread plans which bot
+    uint64_t key = ((uint64_t)rng.Next() << 32) | rng.Next();
+    intents.resize(bots.size());
+    for (int i=0;i<(int)bots.size();++i){
+        auto &in=intents[i];
+        in.toX=bots[i].x; in.toY=bots[i].y;
+        in.attacks.clear();
+        in.signals.clear();
+        in.outOfCycles=false;
+        in.cycles=0;
+        in.rng.Seed(key + (uint64_t)i);
+    }
+    for (int t=0;t<FLOW_TARGET_COUNT;++t){
+        if(flowTargets & (1u<<t)) flowField(t);
+    }
+    planning = true;
+}
+
+void Arena::ResolveTurn(){
+    planning = false;
+    int n=(int)bots.size();
+    for (int i=0;i<n;++i){
+        if(intents[i].outOfCycles) emit(EV_OUT_OF_CYCLES, i, -1, Cell(bots[i].x,bots[i].y), intents[i].cycles);
+    }
+
+    // shots: every trace on the turn-start board first, then the damage
+    struct Shot { int from, dir, target, cell; };
+    std::vector<Shot> shots;
+    for (int i=0;i<n;++i){
+        for (int d : intents[i].attacks){
+            Shot s{i, d, -1, -1};
+            int x=bots[i].x, y=bots[i].y;
+            for(int step=1; step<=cfg.attackRange; ++step){
+                x += dx[d]; y += dy[d];
+                if(!InBounds(x,y)) break;
+                int t=occupancy[Cell(x,y)];
+                if(t!=-1){ s.target=t; s.cell=Cell(x,y); break; }
+            }
+            shots.push_back(s);
+        }
+    }
+    for (const Shot &s : shots){
+        if(s.target<0){
+            emit(EV_MISS, s.from, -1, Cell(bots[s.from].x,bots[s.from].y), s.dir);
+            continue;
+        }
+        auto &t=bots[s.target];
+        t.hp--;
+        emit(EV_HIT, s.from, s.target, s.cell, t.hp);
+        if(t.alive && t.hp<=0){
+            botDied(s.target);
+            emit(EV_DESTROYED, s.from, s.target, s.cell, 0);
+        }
+    }
+
+    // signals, at the positions they were emitted from
+    ClearSignals();
+    for (int i=0;i<n;++i){
+        for (int value : intents[i].signals){
+            signals.emplace_back(bots[i].x, bots[i].y);
+            indexSignal((int)signals.size()-1);
+            emit(EV_SIGNAL, i, -1, Cell(bots[i].x,bots[i].y), value);
+        }
+    }
+
+    // moves: a destination claimed by more than one survivor is a collision
+    // (the grid is all -1 between turns; only claimed cells are reset)
+    if(moveClaims.size()!=(size_t)cfg.width*cfg.height) moveClaims.assign((size_t)cfg.width*cfg.height, -1);
+    for (int i=0;i<n;++i){
+        auto &b=bots[i];
+        if(!b.alive || (intents[i].toX==b.x && intents[i].toY==b.y)) continue;
+        int &claim=moveClaims[Cell(intents[i].toX,intents[i].toY)];
+        claim = claim==-1 ? i : -2;
+    }
+    for (int i=0;i<n;++i){
+        auto &b=bots[i];
+        auto &in=intents[i];
+        if(!b.alive || (in.toX==b.x && in.toY==b.y)) continue;
+        int &claim=moveClaims[Cell(in.toX,in.toY)];
+        bool won = claim==i;
+        claim = -1;
+        if(!won) continue;
+        int dist=std::max(std::abs(in.toX-b.x), std::abs(in.toY-b.y));
+        botMoved(i, in.toX, in.toY);
+        emit(EV_MOVE, i, -1, Cell(b.x,b.y), dist);
+    }
+}
+
+// ===== Sample robots implementation =====
+int Pusher::SetupRobot() {
+    SCAN();                 // Sense nearest enemy (radial). Sets scan_dist/scan_dir
+    IF_SEEN() {             // If something was detected this turn...
+        TURN_SCAN();        //   Face toward the scanned target
+        ATTACK_SCAN();      //   Fire along line-of-sight in that direction
+    }
+    MOVE(1);                // Advance to apply pressure and close distance
+    SIGNAL(1);              // Emit a signal (can be used by others or for logs)
+    return Finalize();      // Seal program and return total script budget used
+}
+
+int Kamikaze::SetupRobot() {
+    SCAN();                 // Look for enemies first
+    IF_SEEN(){              // If a target is visible...
+        TURN_SCAN();        //   Snap to face the target
+        ATTACK_SCAN();      //   Try to land a shot immediately
+        MOVE(1);            //   Keep momentum after firing
+    }
+    MOVE(2);                // Always surge forward (fast, aggressive style)
+    SIGNAL(1);              // Mark presence/pressure zone
+    return Finalize();      // Done
+}
+
+int Shy::SetupRobot() {
+    SCAN();                 // Gather info before deciding
+    IF_SCAN_LE(5){          // If an enemy is within 5 tiles (Chebyshev)...
+        TURN_AWAY();        //   Face away from the threat
+        MOVE(2);            //   Create distance quickly
+        SIGNAL(2);          //   Drop a 'danger' signal (useful for others)
+    } ELSE(){               // Otherwise (no nearby threat)...
+        MOVE(1);            //   Drift slowly to reposition over time
+    }
+    return Finalize();      // Done
+}
+
+int Hunter::SetupRobot() {
+    SCAN();                                 // Always gather info first
+    IF_DAMAGED(){                           // If we took damage last turn...
+        TURN_AWAY();                        //   Face away from the likely attacker
+        MOVE(1);                            //   Create a bit of space
+        SIGNAL(2);                          //   Mark danger zone
+    }
+    IF_SEEN(){                              // If we have a target in memory...
+        IF_CAN_ATTACK(){                    //   If weapon is ready...
+            TURN_SCAN();                    //     Face target
+            ATTACK_SCAN();                  //     Shoot!
+        } ELSE(){                           //   Weapon cooling down
+            IF_SCAN_LE(3){                  //     Too close? back off a little
+                TURN_AWAY();
+                MOVE(1);
+            } ELSE(){
+                TURN_SCAN();                //     Otherwise close the distance
+                MOVE(1);
+            }
+        }
+    }
+    IF_NEAR_EDGE(1){                        // Avoid hugging walls
+        TURN_RANDOM();                      //   Nudge direction randomly
+        MOVE(1);
+    }
+    return Finalize();
+}
+
+// ===== Roster =====
+template <typename T>
+static RobotEntry rosterEntry(){
+    return RobotEntry{ T().name, []{ return std::unique_ptr<RobotBase>(std::make_unique<T>()); } };
+}
+
+std::vector<RobotEntry> ClassRoster(){
+    std::vector<RobotEntry> v;
+    v.push_back(rosterEntry<Pusher>());
+    v.push_back(rosterEntry<Kamikaze>());
+    v.push_back(rosterEntry<Shy>());
+    v.push_back(rosterEntry<Hunter>());
+    return v;
+}
+
+std::vector<std::unique_ptr<RobotBase>> MakeClassBots(){
+    std::vector<std::unique_ptr<RobotBase>> v;
+    for (auto &entry : ClassRoster()) {
+        v.emplace_back(entry.make());
+    }
+    return v;
+}
@@ -0,0 +1,395 @@
+#pragma once
+
+// Headless Robots core: VM, arena mechanics and the sample bots.
+// Nothing in here may depend on ImGui, Grid, Bit or Sprite so that it can be
+// linked into the command line tools as well as the demo.
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RobotsEvents.h"
+#include "RobotsScan.h"
+#include "RobotsVM.h"
+
+// ===== Arena config =====
+static constexpr int ROBOTS_W = 12, ROBOTS_H = 12;        // board size
+static constexpr int MAX_TURNS = 40;        // length of the match
+static constexpr int START_HP = 5;          // health per bot
+static constexpr int MAX_SCRIPT_COST = 20;  // budget per bot (tune in class)
+static constexpr int ATTACK_RANGE = 4;      // line-of-sight attack range
+static constexpr int ATTACK_COOLDOWN = 2;   // turns to cool down after firing
+static constexpr int SCAN_RANGE = 12;        // max scan distance
+static constexpr int MAX_TURN_INSTRUCTIONS = 1000; // VM instructions a bot may run per turn
+
+// Runtime arena configuration. Defaults are the class constants above; the
+// tools override them to run large boards and crowds of bots.
+struct ArenaConfig {
+    int width = ROBOTS_W;
+    int height = ROBOTS_H;
+    int maxTurns = MAX_TURNS;
+    int startHp = START_HP;
+    int attackRange = ATTACK_RANGE;
+    int attackCooldown = ATTACK_COOLDOWN;
+    int scanRange = SCAN_RANGE;
+    int instructionBudget = MAX_TURN_INSTRUCTIONS;  // 0 = unmetered
+    int botCount = 0;       // 0 = one bot per roster entry, else roster entries cloned round-robin
+    bool simultaneous = false;  // every bot plans against the turn-start board, then all intents resolve at once
+};
+
+// ===== Opcodes / DSL =====
+enum OpCode {
+    // actions
+    OP_WAIT, OP_MOVE, OP_TURN, OP_ATTACK, OP_SIGNAL, OP_ATTACK_SCAN, OP_SCAN, OP_TURN_SCAN, OP_TURN_AWAY, OP_TURN_RANDOM,
+    // conditions
+    OP_IF_ENEMY, OP_IF_TURN_LESS, OP_IF_SEEN, OP_IF_SCAN_LE, OP_IF_NEAR_SIGNAL,
+    OP_IF_DAMAGED, OP_IF_HP_LE, OP_IF_CAN_ATTACK, OP_IF_NEAR_EDGE,
+    // flow control
+    OP_JUMP_IF_FALSE, OP_JUMP, OP_END,
+    // actions added later; numbered after OP_END so stored p-code (bundles,
+    // script caches, evolve checkpoints) keeps its meaning
+    OP_MOVE_TOWARD
+};
+
+enum Direction { NORTH=0, EAST=1, SOUTH=2, WEST=3, NORTHEAST=4, SOUTHEAST=5, SOUTHWEST=6, NORTHWEST=7 };
+
+// MOVE_TOWARD's operand: which shared flow field to follow (see Arena::MoveToward)
+enum FlowTarget { TOWARD_ENEMY=0, TOWARD_SIGNAL=1, TOWARD_CENTER=2, FLOW_TARGET_COUNT };
+
+// energy costs (only used for compile‑time budget)
+enum ActionCost { COST_WAIT=0, COST_TURN=1, COST_SIGNAL=1, COST_MOVE=2, COST_ATTACK=3, COST_SCAN=1,
+                  COST_MOVE_TOWARD=COST_TURN+COST_MOVE };
+
+// forward decl
+struct Arena;
+
+// ===== RobotsRng: seedable random stream owned by each Arena =====
+// PCG32 with its own bounded draw; std distributions differ between standard
+// libraries, this does not, so a match seed replays bit-for-bit everywhere.
+struct RobotsRng {
+    uint64_t state = 0x853c49e6748fea9bULL;
+    uint64_t inc = 0xda3e39cb94b95bdbULL;
+
+    void Seed(uint64_t seed);
+    uint32_t Next();
+    int Range(int lo, int hi);      // inclusive
+};
+
+// fresh nondeterministic seed for matches nobody asked to reproduce
+uint64_t RandomSeed();
+
+// ===== RobotBase: tiny VM with an educational macro language =====
+struct RobotBase {
+    std::vector<int> code;        // p‑code
+    int script_cost = 0;     // compile‑time budget
+    std::string name = "Bot";    // printed name
+    struct IfContext { int jumpIfFalseIndex=-1; int jumpToEndIndex=-1; };
+    std::vector<IfContext> _ifCtx;
+
+    // RAII helper so IF_{} patches jump target automatically
+    struct IfBlock {
+        RobotBase* self; IfBlock(RobotBase* s, OpCode cond, int param): self(s){
+            self->code.push_back(cond); self->code.push_back(param);
+            self->code.push_back(OP_JUMP_IF_FALSE); self->code.push_back(0); // placeholder
+            RobotBase::IfContext ctx; ctx.jumpIfFalseIndex = (int)self->code.size()-1; ctx.jumpToEndIndex = -1;
+            self->_ifCtx.push_back(ctx);
+        }
+        ~IfBlock(){
+            if (!self->_ifCtx.empty()){
+                RobotBase::IfContext &ctx = self->_ifCtx.back();
+                // If no ELSE() was emitted, patch false-jump to end of IF block
+                if (ctx.jumpToEndIndex == -1){
+                    self->code[ctx.jumpIfFalseIndex] = (int)self->code.size();
+                }
+                self->_ifCtx.pop_back();
+            }
+        }
+        explicit operator bool() const { return true; }
+    };
+    struct ElseBlock {
+        RobotBase* self;
+        ElseBlock(RobotBase* s): self(s){
+            // Begin ELSE: jump over else body, patch IF's false to here
+            self->code.push_back(OP_JUMP); self->code.push_back(0); // placeholder to end of else
+            int jumpToEndIdx = (int)self->code.size()-1;
+            if (!self->_ifCtx.empty()){
+                RobotBase::IfContext &ctx = self->_ifCtx.back();
+                self->code[ctx.jumpIfFalseIndex] = (int)self->code.size(); // start of ELSE
+                ctx.jumpToEndIndex = jumpToEndIdx;
+            }
+        }
+        ~ElseBlock(){
+            if (!self->_ifCtx.empty()){
+                RobotBase::IfContext &ctx = self->_ifCtx.back();
+                if (ctx.jumpToEndIndex != -1){
+                    self->code[ctx.jumpToEndIndex] = (int)self->code.size(); // end of ELSE
+                }
+            }
+        }
+        explicit operator bool() const { return true; }
+    };
+
+    // DSL: bot coders will use these in SetupRobot()
+    #define MOVE(N)        do{ code.push_back(OP_MOVE); code.push_back((N)); script_cost += COST_MOVE * (N); }while(0)
+    #define TURN(D)        do{ code.push_back(OP_TURN); code.push_back((D)); script_cost += COST_TURN; }while(0)
+    #define ATTACK(D)      do{ code.push_back(OP_ATTACK); code.push_back((D)); script_cost += COST_ATTACK; }while(0)
+    #define ATTACK_SCAN()  do{ code.push_back(OP_ATTACK_SCAN); script_cost += COST_ATTACK; }while(0)
+    #define SIGNAL(V)      do{ code.push_back(OP_SIGNAL); code.push_back((V)); script_cost += COST_SIGNAL; }while(0)
+    #define WAIT_()        do{ code.push_back(OP_WAIT); script_cost += COST_WAIT; }while(0)
+    #define SCAN()         do{ code.push_back(OP_SCAN); script_cost += COST_SCAN; }while(0)
+    #define TURN_SCAN()    do{ code.push_back(OP_TURN_SCAN); script_cost += COST_TURN; }while(0)
+    #define TURN_AWAY()    do{ code.push_back(OP_TURN_AWAY); script_cost += COST_TURN; }while(0)
+    #define TURN_RANDOM()  do{ code.push_back(OP_TURN_RANDOM); script_cost += COST_TURN; }while(0)
+    #define MOVE_TOWARD(T) do{ code.push_back(OP_MOVE_TOWARD); code.push_back((T)); script_cost += COST_MOVE_TOWARD; }while(0)
+
+    #define IF_ENEMY(D)    if (IfBlock _cb##__LINE__{this, OP_IF_ENEMY, (D)})
+    #define IF_TURN_LT(T)  if (IfBlock _cb##__LINE__{this, OP_IF_TURN_LESS, (T)})
+    #define IF_SEEN()      if (IfBlock _cb##__LINE__{this, OP_IF_SEEN, 0})
+    #define IF_SCAN_LE(R)  if (IfBlock _cb##__LINE__{this, OP_IF_SCAN_LE, (R)})
+    #define IF_NEAR_SIGNAL(R) if (IfBlock _cb##__LINE__{this, OP_IF_NEAR_SIGNAL, (R)})
+    #define IF_DAMAGED()   if (IfBlock _cb##__LINE__{this, OP_IF_DAMAGED, 0})
+    #define IF_HP_LE(N)    if (IfBlock _cb##__LINE__{this, OP_IF_HP_LE, (N)})
+    #define IF_CAN_ATTACK() if (IfBlock _cb##__LINE__{this, OP_IF_CAN_ATTACK, 0})
+    #define IF_NEAR_EDGE(R) if (IfBlock _cb##__LINE__{this, OP_IF_NEAR_EDGE, (R)})
+    #define ELSE() else if (ElseBlock _eb##__LINE__{this})
+
+    // seal the script and lower it for the interpreter (see RobotsVM.h)
+    int Finalize(){ code.push_back(OP_END); program = LowerProgram(code, script_cost); return script_cost; }
+    std::shared_ptr<const RobotProgram> program;
+    // compiled twin of the program (see RobotsNative.h); Run prefers it
+    void (*native)(RobotBase &bot, int turn) = nullptr;
+    // per-opcode / Arena-call counters; Run profiles while this is set
+    std::unique_ptr<RobotProfile> profile;
+
+    // hooks provided by Arena at runtime
+    Arena* A = nullptr; int id = -1; // injected
+    virtual int SetupRobot() = 0;    // bot coders will implement this
+    virtual ~RobotBase() = default;
+
+    // interpreter
+    void Run(int turn);
+};
+
+// ===== RobotsDirtyList: bots a view has to resync =====
+// Each bot whose position or alive flag changed since the last Clear(), once,
+// in the order they changed; a view walks this instead of every bot.
+struct RobotsDirtyList {
+    std::vector<int> bots;
+    std::vector<uint8_t> marked;    // bot index -> already in `bots`
+
+    void Mark(int bot) {
+        if (bot >= (int)marked.size()) marked.resize(bot + 1, 0);
+        if (marked[bot]) return;
+        marked[bot] = 1;
+        bots.push_back(bot);
+    }
+    void MarkAll(int count) { for (int i = 0; i < count; ++i) Mark(i); }
+    void Clear() {
+        for (int bot : bots) marked[bot] = 0;
+        bots.clear();
+    }
+};
+
+// ===== Arena state & mechanics =====
+struct Arena {
+    struct BotState {
+        int x=0,y=0;
+        int dir=EAST;
+        int hp=START_HP;
+        int last_hp=START_HP;   // hp snapshot at start of previous turn
+        bool damaged_last_turn=false;
+        bool alive=true;
+        RobotBase* r=nullptr;
+        char glyph='?';
+        int scan_dist=0;   // 0 means nothing seen
+        int scan_dir=-1;   // -1 means none
+        int cooldown=0;    // turns until next attack available
+        int signal=-1;     // value signaled this turn, -1 if none
+        // VM cycle stats (instructions executed)
+        int cycles=0;           // on its last turn
+        int max_cycles=0;
+        long long total_cycles=0;
+        int turns_run=0;
+        int cycle_outs=0;       // turns cut short by cfg.instructionBudget
+    };
+    ArenaConfig cfg;
+    std::vector<BotState> bots;
+    std::array<int,8> dx{0,1,0,-1, 1, 1,-1,-1};
+    std::array<int,8> dy{-1,0,1,0, -1, 1, 1,-1};
+    std::vector<int> occupancy;              // cell (y*W+x) -> index of the live bot on it, -1 if empty
+    std::vector<int> posX, posY;             // SoA mirror of bot positions for the scan kernels (dead = SCAN_FAR)
+    bool batchScan = false;                  // precompute every bot's scan in StartTurn()
+    std::vector<std::pair<int,int>> signals; // positions that emitted a signal this turn (indexed by bucket below)
+    RobotsEventLog* events = nullptr;        // optional event sink, not owned
+    RobotsMatchStats* stats = nullptr;       // optional per-bot tallies of the same events, not owned
+    RobotsDirtyList* dirty = nullptr;        // optional: bots that moved or died (everyone after RebuildOccupancy), not owned
+    RobotsRng rng;                           // drives TURN_RANDOM and spawn shuffling
+
+    // world queries used by VM
+    bool EnemyAdjacent(int self, int dir);
+    int BotAt(int x,int y);
+    bool InBounds(int x,int y);
+    int Cell(int x,int y) const { return y*cfg.width+x; }
+    void Move(int self,int dist);
+    void Turn(int self,int d);
+    void Attack(int self,int d);
+    void AttackScan(int self);
+    void Scan(int self);
+    void Signal(int self, int value);
+    bool HasSignalNearby(int self, int radius);
+    // VM bookkeeping at the end of a bot's turn; outOfCycles = the budget ended it
+    void EndBotTurn(int self, int cycles, bool outOfCycles);
+    void StartTurn();
+    // drop this turn's signals; O(1) apart from the vector clear
+    void ClearSignals();
+    // re-derive occupancy, the SoA positions and the signal index after bot
+    // positions or cfg were written directly (setup, state restore); marks
+    // every bot dirty
+    void RebuildOccupancy();
+    // nearest-enemy scan for every live bot in one pass; Scan() reuses the
+    // result until some bot moves or dies
+    void ScanAll();
+    // TURN_RANDOM's draw: the arena stream, or the bot's own while planning
+    int RandomDirection(int self);
+
+    // ----- flow fields (MOVE_TOWARD) -----
+    // One field per FlowTarget, shared by every bot: the number of 8-way
+    // steps from each cell to the nearest goal, walking free cells only (a
+    // BFS from all goals at once, O(cells)). Goals are the live bots for
+    // TOWARD_ENEMY (the field keeps the two nearest, so a bot never homes in
+    // on itself), this turn's signals for TOWARD_SIGNAL and the middle cells
+    // of the board for TOWARD_CENTER.
+    //
+    // A field is checked at most once per turn, at the first MOVE_TOWARD
+    // that reads it, and only rebuilt when occupancy (or, for
+    // TOWARD_SIGNAL, the signal set) changed since it was built. In
+    // sequential turns bots acting later in a turn follow the field as the
+    // turn started; their moves are still blocked by the live board.
+    // Simultaneous turns build every field in flowTargets in
+    // BeginPlanning(), since bots may plan on several threads; a field
+    // outside it makes MOVE_TOWARD a no-op there.
+    //
+    // MOVE_TOWARD turns the bot to the neighbouring cell nearest the goal
+    // (ties go to its current facing, then the directions after it) and
+    // moves one cell. Next to an enemy that only turns it to face it; on a
+    // goal, or with no path, it does nothing.
+    static constexpr int FLOW_FAR = 1 << 30;    // no path
+    void MoveToward(int self, int target);
+    // steps from (x,y) to `target`'s nearest goal other than bot `self`
+    // (-1 = any), FLOW_FAR if unreachable; refreshes the field like MoveToward
+    int FlowSteps(int target, int x, int y, int self = -1);
+    unsigned flowTargets = 0;                // bit per FlowTarget some bot uses (RobotsMatch::Setup fills it)
+
+    // ----- simultaneous turns (cfg.simultaneous) -----
+    // Between BeginPlanning() and ResolveTurn() the board is a read-only
+    // snapshot of the turn start. A bot only writes its own facing, scan
+    // memory, cooldown and cycle stats; moves, shots and signals go into its
+    // intent instead. Bots therefore see nothing of each other's turn, order
+    // no longer matters, and they may plan on different threads.
+    // ResolveTurn() then applies the intents:
+    //   - shots are traced from the turn-start positions on the turn-start
+    //     board and all land, so two bots can destroy each other;
+    //   - signals are published at the turn-start positions and are what
+    //     IF_NEAR_SIGNAL sees next turn;
+    //   - moves were walked on the turn-start board, so destinations are
+    //     free cells; survivors move there unless several bots claim the
+    //     same cell, in which case none of them moves.
+    struct BotIntent {
+        int toX=0, toY=0;               // where the bot's moves lead
+        std::vector<int> attacks;       // directions fired
+        std::vector<int> signals;       // values SIGNALled
+        bool outOfCycles=false;
+        int cycles=0;
+        RobotsRng rng;                  // this turn's TURN_RANDOM stream
+    };
+    std::vector<BotIntent> intents;
+    bool planning = false;
+    void BeginPlanning();
+    void ResolveTurn();
+private:
+    ScanHit scanFrom(int self);
+    void botMoved(int self, int nx, int ny);
+    void botDied(int t);
+    void emit(RobotsEventType type, int actor, int target, int cell, int value) {
+        if (!events && !stats) return;
+        RobotsEvent e{type, actor, target, cell, value};
+        if (stats) stats->Count(e);
+        // a bot can signal every turn, which would flush the log window
+        if (events && type != EV_SIGNAL) events->Push(e);
+    }
+
+    unsigned posEpoch = 1;                   // bumped whenever a bot moves or dies
+    unsigned scanBatchEpoch = 0;
+    std::vector<ScanHit> scanBatch;
+
+    // signal index: SIGNAL_BUCKET x SIGNAL_BUCKET buckets, each heading a
+    // list threaded through signalNext; a bucket whose stamp is not the
+    // current signalEpoch is empty, so clearing is a counter bump
+    static constexpr int SIGNAL_BUCKET = 8;
+    int signalCols = 0, signalRows = 0;
+    unsigned signalEpoch = 1;
+    std::vector<int> signalHead;
+    std::vector<unsigned> signalStamp;
+    std::vector<int> signalNext;
+    void indexSignal(int s);
+
+    std::vector<int> moveClaims;             // cell -> claiming bot, -2 if contested (ResolveTurn scratch)
+
+    struct FlowField {
+        std::vector<int> dist;      // cell -> steps to the nearest goal, FLOW_FAR if none
+        std::vector<int> owner;     // TOWARD_ENEMY: the bot that goal is
+        std::vector<int> dist2;     // TOWARD_ENEMY: steps to the nearest goal that is not `owner`
+        bool built = false;
+        unsigned posEpoch = 0;      // the board it was built from
+        unsigned signalEpoch = 0;
+        size_t signalCount = 0;
+        unsigned checkedTurn = 0;
+        int Steps(int cell, int self) const { return owner.empty() || owner[cell] != self || self < 0 ? dist[cell] : dist2[cell]; }
+    };
+    struct FlowVisit { int cell, owner, dist; };
+    std::array<FlowField, FLOW_TARGET_COUNT> flow;
+    std::vector<FlowVisit> flowQueue;
+    unsigned flowTurn = 0;                   // bumped by StartTurn
+    bool flowFresh(int target) const;
+    void buildFlow(int target);
+    const FlowField *flowField(int target);
+
+};
+
+// ===== Sample robots =====
+struct Pusher : RobotBase {
+    Pusher(){ name="Pusher"; }
+    int SetupRobot() override;
+};
+
+struct Kamikaze : RobotBase {
+    Kamikaze(){ name="Kamikaze"; }
+    int SetupRobot() override;
+};
+
+struct Shy : RobotBase {
+    Shy(){ name="Shy"; }
+    int SetupRobot() override;
+};
+
+struct Hunter : RobotBase {
+    Hunter(){ name = "Hunter"; }
+    int SetupRobot() override;
+};
+
+// ===== Roster =====
+// a roster slot: display name plus a factory for fresh VM instances, so every
+// match (and every thread) gets its own RobotBase objects
+struct RobotEntry {
+    std::string name;
+    std::function<std::unique_ptr<RobotBase>()> make;
+};
+
+// the class roster every match is played with
+std::vector<RobotEntry> ClassRoster();
+std::vector<std::unique_ptr<RobotBase>> MakeClassBots();
@@ -0,0 +1,310 @@
+#include "RobotsBoardView.h"
+#include "Sprite.h"
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+static constexpr int BAKED_CELL_PX = 64;        // ground texels per cell in the chunk texture
+static constexpr float FLAT_GROUND_PX = 8.0f;   // cells smaller than this get flat ground
+static constexpr float BOT_SPRITE_PX = 12.0f;   // bots smaller than this are colored squares
+static constexpr float OVERLAY_PX = 30.0f;      // overlays only from this cell size up
+static constexpr float MAX_ZOOM = 4.0f;
+static constexpr float ANIM_STEP = 0.05f;       // per frame, as Bit::moveTo
+static constexpr int BOT_TEXTURES = 6;          // robot_01..06.png, then robot_01.png for everyone else
+
+// ===== Textures =====
+namespace {
+    struct BoardTextures {
+        ImTextureID ground = ImTextureID();
+        ImU32 groundColor = IM_COL32(96, 84, 64, 255);      // mean ground texel, for flat ground
+        ImTextureID bots[BOT_TEXTURES] = {};
+    };
+}
+
+// Decoded on first use and kept for the process; every view shares them
+static const BoardTextures &boardTextures()
+{
+    static BoardTextures t;
+    static bool loaded = false;
+    if (loaded) {
+        return t;
+    }
+    loaded = true;
+    for (int slot = 0; slot < BOT_TEXTURES; ++slot) {
+        char filename[32];
+        snprintf(filename, sizeof(filename), "robot_%02d.png", slot + 1);
+        Sprite loader;
+        if (loader.LoadTextureFromFile(filename)) {
+            t.bots[slot] = loader.getTexture();
+        }
+    }
+
+    // ground.png box-filtered down to one baked cell, then repeated over a chunk
+    std::string path = (std::filesystem::path("resources") / "ground.png").string();
+    int w = 0, h = 0;
+    unsigned char *pixels = stbi_load(path.c_str(), &w, &h, NULL, 4);
+    if (!pixels) {
+        return t;
+    }
+    unsigned long long sum[4] = {0, 0, 0, 0};
+    for (int k = 0; k < w * h * 4; ++k) {
+        sum[k & 3] += pixels[k];
+    }
+    unsigned long long n = (unsigned long long)w * h;
+    t.groundColor = IM_COL32(sum[0] / n, sum[1] / n, sum[2] / n, 255);
+
+    std::vector<unsigned char> cell(BAKED_CELL_PX * BAKED_CELL_PX * 4);
+    for (int y = 0; y < BAKED_CELL_PX; ++y) {
+        int sy0 = y * h / BAKED_CELL_PX, sy1 = std::max(sy0 + 1, (y + 1) * h / BAKED_CELL_PX);
+        for (int x = 0; x < BAKED_CELL_PX; ++x) {
+            int sx0 = x * w / BAKED_CELL_PX, sx1 = std::max(sx0 + 1, (x + 1) * w / BAKED_CELL_PX);
+            unsigned acc[4] = {0, 0, 0, 0};
+            for (int sy = sy0; sy < sy1; ++sy) {
+                for (int sx = sx0; sx < sx1; ++sx) {
+                    for (int c = 0; c < 4; ++c) acc[c] += pixels[(sy * w + sx) * 4 + c];
+                }
+            }
+            unsigned count = (unsigned)((sy1 - sy0) * (sx1 - sx0));
+            for (int c = 0; c < 4; ++c) cell[(y * BAKED_CELL_PX + x) * 4 + c] = (unsigned char)(acc[c] / count);
+        }
+    }
+    stbi_image_free(pixels);
+
+    const int side = RobotsBoardView::CHUNK_CELLS * BAKED_CELL_PX;
+    const size_t cellRow = BAKED_CELL_PX * 4;
+    std::vector<unsigned char> chunk((size_t)side * side * 4);
+    for (int y = 0; y < side; ++y) {
+        const unsigned char *src = &cell[(y % BAKED_CELL_PX) * cellRow];
+        unsigned char *dst = &chunk[(size_t)y * side * 4];
+        for (int cx = 0; cx < RobotsBoardView::CHUNK_CELLS; ++cx) {
+            std::copy(src, src + cellRow, dst + cx * cellRow);
+        }
+    }
+    Sprite loader;
+    if (loader.LoadTextureFromPixels(chunk.data(), side, side)) {
+        t.ground = loader.getTexture();
+    }
+    return t;
+}
+
+// ===== Sprites =====
+void RobotsBoardView::Reset(const Arena &arena)
+{
+    if (arena.cfg.width != _boardW || arena.cfg.height != _boardH) {
+        _boardW = arena.cfg.width;
+        _boardH = arena.cfg.height;
+        _fitPending = true;
+    }
+    _sprites.assign(arena.bots.size(), BotSprite());
+    for (size_t i = 0; i < arena.bots.size(); ++i) {
+        BotSprite &s = _sprites[i];
+        const Arena::BotState &b = arena.bots[i];
+        s.onBoard = b.alive;
+        s.x = s.fromX = s.toX = (float)b.x;
+        s.y = s.fromY = s.toY = (float)b.y;
+    }
+}
+
+void RobotsBoardView::Sync(const Arena &arena, RobotsDirtyList &dirty)
+{
+    // Only the bots that moved, died or were restored since the last sync.
+    // Dead bots keep their sprite, off the board, for scrubbing back to a
+    // turn they lived.
+    for (int i : dirty.bots) {
+        if (i >= (int)_sprites.size()) continue;
+        BotSprite &s = _sprites[i];
+        const Arena::BotState &b = arena.bots[i];
+        if (!b.alive) {
+            s.onBoard = false;
+            continue;
+        }
+        s.toX = (float)b.x;
+        s.toY = (float)b.y;
+        if (s.onBoard) {
+            // animated from wherever it is now
+            s.fromX = s.x;
+            s.fromY = s.y;
+            s.t = 0.0f;
+        } else {
+            s.x = s.fromX = s.toX;
+            s.y = s.fromY = s.toY;
+            s.t = 1.0f;
+            s.onBoard = true;
+        }
+    }
+    dirty.Clear();
+}
+
+// ===== Camera =====
+float RobotsBoardView::minZoom(const ImVec2 &size) const
+{
+    float fit = std::min(size.x / (_boardW * CELL_PX), size.y / (_boardH * CELL_PX));
+    return std::min(fit, 1.0f) * 0.5f;
+}
+
+void RobotsBoardView::fitNow(const ImVec2 &size)
+{
+    _zoom = std::min(1.0f, std::min(size.x / (_boardW * CELL_PX), size.y / (_boardH * CELL_PX)));
+    _cameraX = _boardW * 0.5f;
+    _cameraY = _boardH * 0.5f;
+    _fitPending = false;
+}
+
+// ===== Drawing =====
+void RobotsBoardView::Draw(const RobotsMatch &match)
+{
+    _drawnChunks = 0;
+    _drawnBots = 0;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 size = ImGui::GetContentRegionAvail();
+    if (size.x < 1.0f || size.y < 1.0f || _boardW <= 0 || _boardH <= 0) {
+        return;
+    }
+    if (_fitPending) {
+        fitNow(size);
+    }
+    const BoardTextures &tex = boardTextures();
+
+    // Pan with any mouse button, zoom about the cursor with the wheel
+    ImGui::InvisibleButton("robots_board", size, ImGuiButtonFlags_MouseButtonLeft | ImGuiButtonFlags_MouseButtonRight | ImGuiButtonFlags_MouseButtonMiddle);
+    ImGuiIO &io = ImGui::GetIO();
+    float cell = CELL_PX * _zoom;
+    if (ImGui::IsItemActive()) {
+        _cameraX -= io.MouseDelta.x / cell;
+        _cameraY -= io.MouseDelta.y / cell;
+    }
+    if (ImGui::IsItemHovered() && io.MouseWheel != 0.0f) {
+        float mx = io.MousePos.x - (origin.x + size.x * 0.5f);
+        float my = io.MousePos.y - (origin.y + size.y * 0.5f);
+        float wx = _cameraX + mx / cell, wy = _cameraY + my / cell;     // stays under the cursor
+        _zoom = std::clamp(_zoom * std::pow(1.2f, io.MouseWheel), minZoom(size), MAX_ZOOM);
+        cell = CELL_PX * _zoom;
+        _cameraX = wx - mx / cell;
+        _cameraY = wy - my / cell;
+    }
+    _cameraX = std::clamp(_cameraX, 0.0f, (float)_boardW);
+    _cameraY = std::clamp(_cameraY, 0.0f, (float)_boardH);
+
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    drawList->PushClipRect(origin, ImVec2(origin.x + size.x, origin.y + size.y), true);
+    ImVec2 clipMin = drawList->GetClipRectMin(), clipMax = drawList->GetClipRectMax();
+    // screen position of cell (0, 0)
+    ImVec2 o(std::floor(origin.x + size.x * 0.5f - _cameraX * cell), std::floor(origin.y + size.y * 0.5f - _cameraY * cell));
+
+    // visible cells, [x0, x1) x [y0, y1)
+    int x0 = std::max(0, (int)std::floor((clipMin.x - o.x) / cell));
+    int y0 = std::max(0, (int)std::floor((clipMin.y - o.y) / cell));
+    int x1 = std::min(_boardW, (int)std::ceil((clipMax.x - o.x) / cell));
+    int y1 = std::min(_boardH, (int)std::ceil((clipMax.y - o.y) / cell));
+    if (x0 < x1 && y0 < y1) {
+        if (cell < FLAT_GROUND_PX || !tex.ground) {
+            drawList->AddRectFilled(ImVec2(o.x + x0 * cell, o.y + y0 * cell), ImVec2(o.x + x1 * cell, o.y + y1 * cell), tex.groundColor);
+        } else {
+            // one quad per visible chunk; edge chunks use part of the texture
+            for (int cy = y0 / CHUNK_CELLS; cy * CHUNK_CELLS < y1; ++cy) {
+                int rows = std::min(CHUNK_CELLS, _boardH - cy * CHUNK_CELLS);
+                for (int cx = x0 / CHUNK_CELLS; cx * CHUNK_CELLS < x1; ++cx) {
+                    int cols = std::min(CHUNK_CELLS, _boardW - cx * CHUNK_CELLS);
+                    ImVec2 p0(o.x + cx * CHUNK_CELLS * cell, o.y + cy * CHUNK_CELLS * cell);
+                    ImVec2 p1(p0.x + cols * cell, p0.y + rows * cell);
+                    drawList->AddImage(tex.ground, p0, p1, ImVec2(0, 0), ImVec2((float)cols / CHUNK_CELLS, (float)rows / CHUNK_CELLS));
+                    _drawnChunks++;
+                }
+            }
+        }
+    }
+    drawList->AddRect(ImVec2(o.x, o.y), ImVec2(o.x + _boardW * cell, o.y + _boardH * cell), IM_COL32(0, 0, 0, 255));
+
+    // Bots: every sprite advances its animation, only the visible ones are
+    // drawn. Overlays hang over the neighbouring cells, hence the margin.
+    static const ImU32 SEAT_COLORS[BOT_TEXTURES] = {
+        IM_COL32(230, 80, 70, 255), IM_COL32(70, 150, 230, 255), IM_COL32(90, 200, 90, 255),
+        IM_COL32(230, 200, 60, 255), IM_COL32(190, 100, 220, 255), IM_COL32(240, 140, 60, 255),
+    };
+    const bool overlays = cell >= OVERLAY_PX;
+    const float margin = overlays ? cell : 0.0f;
+    for (size_t i = 0; i < _sprites.size() && i < match.arena.bots.size(); ++i) {
+        BotSprite &s = _sprites[i];
+        if (s.t < 1.0f) {
+            s.t = std::min(1.0f, s.t + ANIM_STEP);
+            s.x = s.fromX + (s.toX - s.fromX) * s.t;
+            s.y = s.fromY + (s.toY - s.fromY) * s.t;
+        }
+        if (!s.onBoard) continue;
+        ImVec2 p(o.x + s.x * cell, o.y + s.y * cell);
+        if (p.x + cell + margin < clipMin.x || p.x - margin > clipMax.x || p.y + cell + margin < clipMin.y || p.y - margin > clipMax.y) {
+            continue;
+        }
+        ImVec2 q(p.x + cell, p.y + cell);
+        int slot = i < BOT_TEXTURES ? (int)i : 0;
+        if (cell < BOT_SPRITE_PX || !tex.bots[slot]) {
+            drawList->AddRectFilled(p, q, SEAT_COLORS[i % BOT_TEXTURES]);
+        } else {
+            drawList->AddImage(tex.bots[slot], p, q);
+        }
+        if (overlays) {
+            drawOverlays(drawList, match, (int)i, p, cell);
+        }
+        _drawnBots++;
+    }
+    drawList->PopClipRect();
+}
+
+// health bar and name above the sprite, facing arrow over it; sized for a
+// CELL_PX cell and scaled with the zoom
+void RobotsBoardView::drawOverlays(ImDrawList *drawList, const RobotsMatch &match, int i, ImVec2 p, float cell)
+{
+    const Arena::BotState &bs = match.arena.bots[i];
+    const float s = cell / CELL_PX;
+
+    // Health bar geometry (above the sprite)
+    const float barWidth = cell;
+    const float barHeight = 6.0f * s;
+    const float barYOffset = 8.0f * s;
+    ImVec2 barTL = ImVec2(p.x, p.y - barYOffset - barHeight);
+    ImVec2 barBR = ImVec2(p.x + barWidth, p.y - barYOffset);
+
+    // Background
+    drawList->AddRectFilled(barTL, barBR, IM_COL32(40, 40, 40, 200), 2.0f * s);
+    // Health fill
+    float ratio = (float)bs.hp / (float)match.arena.cfg.startHp;
+    ratio = std::clamp(ratio, 0.0f, 1.0f);
+    ImVec2 fillBR = ImVec2(barTL.x + barWidth * ratio, barBR.y);
+    // Gradient-ish color from red to green
+    int r = (int)((1.0f - ratio) * 220.0f);
+    int g = (int)(ratio * 220.0f);
+    drawList->AddRectFilled(barTL, fillBR, IM_COL32(r, g, 64, 230), 2.0f * s);
+    drawList->AddRect(barTL, barBR, IM_COL32(0, 0, 0, 200), 2.0f * s, 0, 1.0f);
+
+    // Name label below the health bar
+    const char *label = i < (int)match.bots.size() && match.bots[i] ? match.bots[i]->name.c_str() : "?";
+    drawList->AddText(ImGui::GetFont(), ImGui::GetFontSize() * s, ImVec2(barTL.x, barBR.y + 2.0f * s), IM_COL32(255, 255, 255, 255), label);
+
+    // Facing direction (arrow)
+    int dir = bs.dir;
+    if (dir < 0 || dir >= 8) {
+        return;
+    }
+    float vx = (float)match.arena.dx[dir];
+    float vy = (float)match.arena.dy[dir];
+    float mag = std::sqrt(vx * vx + vy * vy);
+    if (mag <= 0.0f) {
+        return;
+    }
+    ImVec2 center = ImVec2(p.x + cell * 0.5f, p.y + cell * 0.5f);
+    float len = 18.0f * s;
+    ImVec2 v = ImVec2(vx / mag * len, vy / mag * len);
+    ImVec2 tip = ImVec2(center.x + v.x, center.y + v.y);
+    ImU32 col = IM_COL32(80, 220, 255, 220);
+    // main shaft
+    drawList->AddLine(center, tip, col, 2.0f * s);
+    // arrow head
+    ImVec2 back = ImVec2(tip.x - v.x * 0.35f, tip.y - v.y * 0.35f);
+    ImVec2 perp = ImVec2(-v.y / len, v.x / len);   // normalized perpendicular
+    float headW = 5.0f * s;
+    ImVec2 left = ImVec2(back.x + perp.x * headW, back.y + perp.y * headW);
+    ImVec2 right = ImVec2(back.x - perp.x * headW, back.y - perp.y * headW);
+    drawList->AddTriangleFilled(left, tip, right, col);
+}
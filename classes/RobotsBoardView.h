@@ -0,0 +1,59 @@
+#pragma once
+
+#include "RobotsMatch.h"
+#include "../imgui/imgui.h"
+#include <vector>
+
+// ===== RobotsBoardView =====
+// Draws the Robots board, its bots and their overlays into the current
+// window, for any board size. The ground is baked once into a texture
+// covering CHUNK_CELLS x CHUNK_CELLS cells and drawn as one quad per visible
+// chunk; cells, bots and overlays outside the window's clip rect are never
+// submitted. Drag to pan, mouse wheel to zoom about the cursor. Zoomed far
+// out the ground is one flat rect, bots are colored squares and the health
+// bars, names and facing arrows are left out.
+//
+// Sprites live as long as the match: Reset() places every bot, Sync() then
+// touches only the bots the arena marked dirty. Textures are decoded once per
+// process and shared by every view.
+class RobotsBoardView
+{
+public:
+    static constexpr int CHUNK_CELLS = 16;
+    static constexpr float CELL_PX = 60.0f;     // a cell at zoom 1, the size of a bot sprite
+
+    // a new match; the camera is kept if the board size is unchanged
+    void Reset(const Arena &arena);
+    void Sync(const Arena &arena, RobotsDirtyList &dirty);
+    // fills the rest of the window's content region
+    void Draw(const RobotsMatch &match);
+    // the whole board in view, next Draw
+    void Fit() { _fitPending = true; }
+
+    float Zoom() const { return _zoom; }
+    // what the last Draw submitted
+    int DrawnChunks() const { return _drawnChunks; }
+    int DrawnBots() const { return _drawnBots; }
+
+private:
+    struct BotSprite {
+        float x = 0.0f, y = 0.0f;           // in cells, animated
+        float fromX = 0.0f, fromY = 0.0f;
+        float toX = 0.0f, toY = 0.0f;
+        float t = 1.0f;                     // 1 = arrived
+        bool onBoard = false;
+    };
+
+    void fitNow(const ImVec2 &size);
+    float minZoom(const ImVec2 &size) const;
+    void drawOverlays(ImDrawList *drawList, const RobotsMatch &match, int i, ImVec2 p, float cell);
+
+    std::vector<BotSprite> _sprites;
+    int _boardW = 0, _boardH = 0;
+    float _cameraX = 0.0f;                  // board position at the view center, in cells
+    float _cameraY = 0.0f;
+    float _zoom = 1.0f;
+    bool _fitPending = true;                // fitting needs the window size, known in Draw
+    int _drawnChunks = 0;
+    int _drawnBots = 0;
+};
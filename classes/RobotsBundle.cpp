@@ -0,0 +1,181 @@
+#include "RobotsBundle.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char BUNDLE_MAGIC[4] = {'R', 'B', 'B', 'N'};
+static constexpr uint32_t BUNDLE_VERSION = 1;
+static constexpr size_t HEADER_BYTES = 16;
+static constexpr size_t ENTRY_BYTES = 20;
+
+// ===== byte encoding =====
+static void putU32(std::vector<uint8_t> &out, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+static uint32_t getU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static bool littleEndianHost()
+{
+    const uint32_t one = 1;
+    uint8_t first;
+    memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+// ===== WriteBotBundle =====
+bool WriteBotBundle(const std::string &path, const std::vector<RobotEntry> &roster, std::string *error)
+{
+    auto fail = [&](const std::string &why) {
+        if (error) *error = why;
+        return false;
+    };
+    std::vector<uint8_t> entries, names, blob;
+    uint32_t codeInts = 0;
+    for (const RobotEntry &entry : roster) {
+        std::unique_ptr<RobotBase> bot = entry.make();
+        int cost = bot->SetupRobot();
+        if (bot->code.empty()) return fail(entry.name + " has no p-code to bundle");
+        putU32(entries, (uint32_t)names.size());
+        putU32(entries, (uint32_t)entry.name.size());
+        putU32(entries, (uint32_t)cost);
+        putU32(entries, codeInts);
+        putU32(entries, (uint32_t)bot->code.size());
+        names.insert(names.end(), entry.name.begin(), entry.name.end());
+        for (int v : bot->code) putU32(blob, (uint32_t)v);
+        codeInts += (uint32_t)bot->code.size();
+    }
+    names.resize((names.size() + 3) & ~(size_t)3, 0);
+
+    std::vector<uint8_t> out(BUNDLE_MAGIC, BUNDLE_MAGIC + 4);
+    putU32(out, BUNDLE_VERSION);
+    putU32(out, (uint32_t)roster.size());
+    putU32(out, codeInts);
+    out.insert(out.end(), entries.begin(), entries.end());
+    out.insert(out.end(), names.begin(), names.end());
+    out.insert(out.end(), blob.begin(), blob.end());
+
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) return fail("cannot write " + path);
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    ok = fclose(f) == 0 && ok;
+    return ok ? true : fail("cannot write " + path);
+}
+
+// ===== RobotsBundle =====
+bool RobotsBundle::Open(const std::string &path, std::string *error)
+{
+    auto fail = [&](const std::string &why) {
+        if (error) *error = why;
+        Close();
+        return false;
+    };
+    Close();
+
+#if defined(_WIN32)
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail("cannot read " + path);
+    _buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    _data = _buffer.data();
+    _size = _buffer.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail("cannot read " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)HEADER_BYTES) {
+        close(fd);
+        return fail("not a Robots bot bundle");
+    }
+    void *map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);      // the mapping keeps the file
+    if (map == MAP_FAILED) return fail("cannot map " + path);
+    _data = (const uint8_t *)map;
+    _size = (size_t)st.st_size;
+    _mapped = true;
+#endif
+
+    if (_size < HEADER_BYTES || memcmp(_data, BUNDLE_MAGIC, 4) != 0) return fail("not a Robots bot bundle");
+    if (getU32(_data + 4) != BUNDLE_VERSION) return fail("unsupported bundle version");
+    uint64_t count = getU32(_data + 8);
+    uint64_t codeInts = getU32(_data + 12);
+    uint64_t namesAt = HEADER_BYTES + count * ENTRY_BYTES;
+    if (namesAt + codeInts * 4 > _size) return fail("truncated bundle");
+    uint64_t codeAt = _size - codeInts * 4;
+    if (codeAt % 4 != 0) return fail("corrupt bundle");
+    _code = _data + codeAt;
+
+    // little-endian hosts read the blob in place; others decode each program
+    const bool inPlace = littleEndianHost();
+    std::vector<int> decoded;
+    _bots.resize((size_t)count);
+    for (size_t i = 0; i < _bots.size(); ++i) {
+        const uint8_t *e = _data + HEADER_BYTES + i * ENTRY_BYTES;
+        uint64_t nameOffset = getU32(e), nameLength = getU32(e + 4);
+        int scriptCost = (int)getU32(e + 8);
+        uint32_t codeOffset = getU32(e + 12), codeLength = getU32(e + 16);
+        if (namesAt + nameOffset + nameLength > codeAt || (uint64_t)codeOffset + codeLength > codeInts) {
+            return fail("corrupt bundle");
+        }
+        Bot &bot = _bots[i];
+        bot.name.assign((const char *)_data + namesAt + nameOffset, (size_t)nameLength);
+        bot.codeOffset = codeOffset;
+        bot.codeLength = codeLength;
+        const int *code = (const int *)(_code + 4 * (size_t)codeOffset);
+        if (!inPlace) {
+            decoded = Code((int)i);
+            code = decoded.data();
+        }
+        // a stale or crafted bundle must not reach the arena
+        std::string why;
+        if (!CheckProgramCode(code, (int)codeLength, scriptCost, &why)) return fail(bot.name + ": " + why);
+        bot.program = LowerProgram(code, (int)codeLength, scriptCost);
+    }
+    return true;
+}
+
+void RobotsBundle::Close()
+{
+#if !defined(_WIN32)
+    if (_mapped) munmap((void *)_data, _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+    _buffer.clear();
+    _code = nullptr;
+    _bots.clear();
+}
+
+std::vector<int> RobotsBundle::Code(int i) const
+{
+    const Bot &bot = _bots[i];
+    std::vector<int> code(bot.codeLength);
+    const uint8_t *p = _code + 4 * (size_t)bot.codeOffset;
+    for (uint32_t k = 0; k < bot.codeLength; ++k, p += 4) code[k] = (int)getU32(p);
+    return code;
+}
+
+std::vector<RobotEntry> RobotsBundle::Roster() const
+{
+    std::vector<RobotEntry> v;
+    v.reserve(_bots.size());
+    for (const Bot &bot : _bots) {
+        std::string name = bot.name;
+        std::shared_ptr<const RobotProgram> program = bot.program;
+        v.push_back(RobotEntry{ name, [name, program]{ return std::unique_ptr<RobotBase>(std::make_unique<BundleBot>(name, program)); } });
+    }
+    return v;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "RobotsArena.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ===== Bot bundles =====
+// A roster compiled once into one file: every bot's name, script_cost and
+// p-code, so a tournament with thousands of entrants neither constructs nor
+// runs SetupRobot() for every bot in every match. RobotsBundle maps the file
+// read-only and lowers each program once; every match then shares that one
+// image (BundleBot::SetupRobot only takes a reference to it, and copies no
+// p-code).
+//
+// File layout (all integers little-endian):
+//   "RBBN" u32 version, u32 bots, u32 code ints in total
+//   per bot: u32 name offset, u32 name length (into the name table),
+//            i32 script_cost, u32 code offset, u32 code length (ints, into
+//            the code blob)
+//   the name table, zero-padded to a multiple of 4 bytes
+//   the code blob, i32 per p-code int
+// The code blob starts 4-byte aligned, so a little-endian host lowers the
+// programs straight out of the mapping. Open() checks every program with
+// CheckProgramCode first and fails on the first one out of range.
+
+// SetupRobot() every entry once and write the result; the bots keep their
+// roster names
+bool WriteBotBundle(const std::string &path, const std::vector<RobotEntry> &roster, std::string *error = nullptr);
+
+// A bot whose program comes from a bundle; cheap to construct and set up.
+struct BundleBot : RobotBase {
+    BundleBot(const std::string &botName, std::shared_ptr<const RobotProgram> lowered)
+        : _lowered(std::move(lowered)) { name = botName; }
+    int SetupRobot() override {
+        program = _lowered;
+        script_cost = _lowered->scriptCost;
+        return script_cost;
+    }
+
+private:
+    std::shared_ptr<const RobotProgram> _lowered;
+};
+
+class RobotsBundle
+{
+public:
+    RobotsBundle() = default;
+    RobotsBundle(const RobotsBundle &) = delete;
+    RobotsBundle &operator=(const RobotsBundle &) = delete;
+    ~RobotsBundle() { Close(); }
+
+    bool Open(const std::string &path, std::string *error = nullptr);
+    void Close();
+
+    int Size() const { return (int)_bots.size(); }
+    const std::string &Name(int i) const { return _bots[i].name; }
+    int ScriptCost(int i) const { return _bots[i].program->scriptCost; }
+    // the p-code as stored, read from the mapping
+    std::vector<int> Code(int i) const;
+    const std::shared_ptr<const RobotProgram> &Program(int i) const { return _bots[i].program; }
+
+    // one entry per bot, making BundleBots; the entries share the lowered
+    // programs and stay valid after the bundle is closed
+    std::vector<RobotEntry> Roster() const;
+
+private:
+    struct Bot {
+        std::string name;
+        uint32_t codeOffset = 0, codeLength = 0;
+        std::shared_ptr<const RobotProgram> program;
+    };
+
+    const uint8_t *_data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;               // false: _data points into _buffer
+    std::vector<uint8_t> _buffer;
+    const uint8_t *_code = nullptr;     // start of the code blob
+    std::vector<Bot> _bots;
+};
@@ -0,0 +1,116 @@
+#include "RobotsCompare.h"
+#include "RobotsMatch.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // each version's result in one game: 1 win, 0 draw, -1 loss; written by
+    // exactly one task each
+    struct GameOutcome {
+        int a = 0;
+        int b = 0;
+    };
+}
+
+double EloFromScore(double score)
+{
+    score = std::clamp(score, 1e-6, 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double ScoreFromElo(double elo)
+{
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+// a draw is surviving the turn limit with the opponent still standing
+static int playGame(const RobotEntry &bot, const RobotEntry &opponent, int seat, uint64_t seed)
+{
+    std::vector<std::unique_ptr<RobotBase>> bots;
+    bots.emplace_back(bot.make());
+    bots.emplace_back(opponent.make());
+    if (seat == 1) std::swap(bots[0], bots[1]);
+    RobotsMatch match;
+    match.Setup(std::move(bots), seed);
+    match.Play();
+    int winner = match.Winner();
+    return winner == seat ? 1 : (winner == -1 && match.arena.bots[seat].alive ? 0 : -1);
+}
+
+static void tally(TournamentRecord &record, int outcome)
+{
+    record.played++;
+    if (outcome > 0) record.wins++;
+    else if (outcome == 0) record.draws++;
+    else record.losses++;
+}
+
+CompareResult RunComparison(const RobotEntry &a, const RobotEntry &b, const std::vector<RobotEntry> &pool, const CompareOptions &options)
+{
+    CompareResult result;
+    result.nameA = a.name;
+    result.nameB = b.name;
+    result.seed = options.seed;
+    result.lower = std::log(options.beta / (1.0 - options.alpha));
+    result.upper = std::log((1.0 - options.beta) / options.alpha);
+    const double s0 = ScoreFromElo(options.elo0), s1 = ScoreFromElo(options.elo1);
+    if (pool.empty() || options.maxGames <= 0) {
+        return result;
+    }
+
+    // One pseudo-game at x = 0 and one at x = 1 seed the variance, so a
+    // handful of identical early games cannot decide the test on a variance
+    // of nearly zero; the Elo estimate uses the real games only.
+    double sum = 1.0, sumSq = 1.0;
+    int seen = 2;
+
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool workers(options.threads);
+    result.threads = workers.Size();
+    const int batch = options.batch > 0 ? options.batch : 32 * (int)workers.Size();
+    const int poolSize = (int)pool.size();
+    std::vector<GameOutcome> outcomes;
+    for (int first = 0; first < options.maxGames && result.verdict == 0; first += batch) {
+        int count = std::min(batch, options.maxGames - first);
+        outcomes.assign(count, GameOutcome());
+        for (int k = 0; k < count; ++k) {
+            int g = first + k;
+            int opponent = (g / 2) % poolSize;
+            uint64_t seed = options.seed + (uint64_t)g;
+            // A and B as separate tasks: twice the parallelism in a batch
+            workers.Submit([&, k, g, opponent, seed] { outcomes[k].a = playGame(a, pool[opponent], g % 2, seed); });
+            workers.Submit([&, k, g, opponent, seed] { outcomes[k].b = playGame(b, pool[opponent], g % 2, seed); });
+        }
+        workers.Wait();
+        result.matchesPlayed += 2 * count;
+
+        // in game order, so the stop does not depend on the thread count
+        for (int k = 0; k < count && result.verdict == 0; ++k) {
+            const GameOutcome &out = outcomes[k];
+            tally(result.a, out.a);
+            tally(result.b, out.b);
+            double x = (2.0 + out.a - out.b) / 4.0;
+            sum += x;
+            sumSq += x * x;
+            seen++;
+            result.games++;
+
+            double mean = sum / seen;
+            double variance = sumSq / seen - mean * mean;
+            result.llr = (s1 - s0) * (2.0 * mean - s0 - s1) * seen / (2.0 * variance);
+            if (result.llr >= result.upper) result.verdict = 1;
+            else if (result.llr <= result.lower) result.verdict = -1;
+        }
+    }
+    result.matches = 2 * result.games;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double n = result.games;
+    double mean = (sum - 1.0) / n;
+    double spread = 1.96 * std::sqrt(std::max((sumSq - 1.0) / n - mean * mean, 0.0) / n);
+    result.elo = EloFromScore(mean);
+    result.eloError = (EloFromScore(mean + spread) - EloFromScore(mean - spread)) / 2.0;
+    return result;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RobotsTournament.h"
+
+// ===== A/B comparison of two bot versions =====
+// A and B each play the same games against an opponent pool: game g is a
+// 1v1 against pool[(g / 2) % pool size], in seat g % 2, with seed seed + g.
+// Matches are deterministic given their bots and seed, so the two results of
+// a game differ only through the bot under test, and each game yields one
+// paired score x = (1 + scoreA - scoreB) / 2 (a win scores 1, a draw 0.5).
+//
+// A sequential probability ratio test on x decides between
+//   H0: A is elo0 stronger than B   and   H1: A is elo1 stronger than B
+// (the generalized SPRT with a normal approximation, as chess engine testing
+// uses). After each game the log-likelihood ratio is compared with the
+// Wald bounds log(beta / (1 - alpha)) and log((1 - beta) / alpha); the run
+// stops at the first game that crosses one, or after maxGames.
+//
+// Games are played in batches on a WorkStealingPool and tallied in game
+// order, so where a run stops (and everything it reports) depends only on
+// the seed, never on the thread count; a batch may play a few games past the
+// stop, which are not counted.
+struct CompareOptions {
+    double elo0 = 0.0;
+    double elo1 = 10.0;
+    double alpha = 0.05;            // chance of accepting H1 when H0 holds
+    double beta = 0.05;             // chance of accepting H0 when H1 holds
+    int maxGames = 20000;           // undecided after this many
+    int batch = 0;                  // games per parallel batch, 0 = 32 per thread
+    unsigned threads = 0;           // 0 = one per core
+    uint64_t seed = 0;              // game g is played with seed + g
+};
+
+struct CompareResult {
+    std::string nameA, nameB;
+    int verdict = 0;                // 1: H1 accepted (A stronger), -1: H0 accepted, 0: undecided
+    int games = 0;                  // games counted, each played by A and by B
+    int matches = 0;                // matches counted, 2 per game
+    int matchesPlayed = 0;          // including those after the stop
+    TournamentRecord a, b;          // against the pool
+    double llr = 0.0;
+    double lower = 0.0, upper = 0.0;    // the SPRT bounds
+    double elo = 0.0;               // A minus B, from the mean paired score
+    double eloError = 0.0;          // 95% interval half-width
+    double seconds = 0.0;
+    unsigned threads = 0;
+    uint64_t seed = 0;
+};
+
+// Elo difference for an expected score, and back
+double EloFromScore(double score);
+double ScoreFromElo(double elo);
+
+CompareResult RunComparison(const RobotEntry &a, const RobotEntry &b, const std::vector<RobotEntry> &pool, const CompareOptions &options);
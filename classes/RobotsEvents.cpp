@@ -0,0 +1,82 @@
+#include "RobotsEvents.h"
+#include "RobotsArena.h"
+#include <cstdio>
+
+RobotsEventLog::RobotsEventLog(size_t capacity)
+{
+    // round up to a power of two so the ring index is a mask
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    _ring.resize(size);
+    _mask = size - 1;
+}
+
+void RobotsEventLog::Note(const std::string &text)
+{
+    RobotsEvent e;
+    e.type = EV_NOTE;
+    e.value = (int32_t)_notes.size();
+    _notes.push_back(text);
+    Push(e);
+}
+
+void RobotsEventLog::Clear()
+{
+    _next = 0;
+    _notes.clear();
+}
+
+static const char *botName(const Arena &arena, int index)
+{
+    if (index < 0 || index >= (int)arena.bots.size() || !arena.bots[index].r) return "Bot";
+    return arena.bots[index].r->name.c_str();
+}
+
+// board coordinates as the arena numbers them, e.g. "(2,3)"; letters run
+// out past 26 columns and boards are sized at runtime
+static void squareName(const Arena &arena, int cell, char *buf, size_t size)
+{
+    int width = arena.cfg.width > 0 ? arena.cfg.width : 1;
+    snprintf(buf, size, "(%d,%d)", cell % width, cell / width);
+}
+
+int RobotsEventLog::Format(const RobotsEvent &e, const Arena &arena, char *buf, size_t size) const
+{
+    char square[32];
+    switch (e.type) {
+        case EV_MOVE:
+            squareName(arena, e.cell, square, sizeof(square));
+            return snprintf(buf, size, "%s moves to %s", botName(arena, e.actor), square);
+        case EV_HIT:
+            return snprintf(buf, size, "%s attacks %s for 1 point!", botName(arena, e.actor), botName(arena, e.target));
+        case EV_DESTROYED:
+            return snprintf(buf, size, "%s is destroyed!", botName(arena, e.target));
+        case EV_MISS:
+            return snprintf(buf, size, "%s fires and misses.", botName(arena, e.actor));
+        case EV_OUT_OF_CYCLES:
+            return snprintf(buf, size, "%s runs out of cycles after %d instructions", botName(arena, e.actor), e.value);
+        case EV_DRAW:
+            return snprintf(buf, size, "Draw: maximum turns reached.");
+        case EV_SIGNAL:
+            return snprintf(buf, size, "%s signals %d", botName(arena, e.actor), e.value);
+        case EV_NOTE:
+            if (e.value >= 0 && e.value < (int32_t)_notes.size()) {
+                return snprintf(buf, size, "%s", _notes[e.value].c_str());
+            }
+            break;
+    }
+    if (size) buf[0] = 0;
+    return 0;
+}
+
+std::string RobotsEventLog::Text(const RobotsEvent &e, const Arena &arena) const
+{
+    char buf[256];
+    int n = Format(e, arena, buf, sizeof(buf));
+    if (n >= (int)sizeof(buf)) {
+        std::string text(n, '\0');
+        Format(e, arena, &text[0], (size_t)n + 1);
+        return text;
+    }
+    return std::string(buf, n > 0 ? (size_t)n : 0);
+}
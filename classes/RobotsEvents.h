@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Arena;
+
+// ===== Arena events =====
+// The arena reports what happens as small fixed-size records instead of
+// text. Nothing is formatted until someone looks at a record, and with no
+// log attached (Arena::events == nullptr) an event costs one pointer test.
+enum RobotsEventType : uint8_t {
+    EV_MOVE,            // actor moved `value` squares, ending on `cell`
+    EV_HIT,             // actor shot target on `cell`, target left with `value` hp
+    EV_DESTROYED,       // actor's shot destroyed target on `cell`
+    EV_MISS,            // actor fired in direction `value` from `cell` and missed
+    EV_OUT_OF_CYCLES,   // actor's turn was cut after `value` instructions
+    EV_DRAW,            // turn limit `value` reached with several bots standing
+    EV_NOTE,            // free text, `value` indexes RobotsEventLog notes
+    EV_SIGNAL,          // actor signalled `value` from `cell` (tallied, never logged)
+};
+
+struct RobotsEvent {
+    RobotsEventType type = EV_NOTE;
+    int32_t actor = -1;     // bot index, -1 if none
+    int32_t target = -1;    // bot index, -1 if none
+    int32_t cell = -1;      // Arena::Cell(x,y), -1 if none
+    int32_t value = 0;
+};
+
+// Fixed-capacity ring of events; once full the oldest records are
+// overwritten, so pushing is O(1) however long the match runs.
+class RobotsEventLog
+{
+public:
+    explicit RobotsEventLog(size_t capacity = 4096);
+
+    void Push(const RobotsEvent &e)
+    {
+        _ring[_next & _mask] = e;
+        _next++;
+    }
+    // setup and UI messages that are not arena events; keep these rare
+    void Note(const std::string &text);
+    void Clear();
+
+    size_t Size() const { return _next < _ring.size() ? (size_t)_next : _ring.size(); }
+    size_t Capacity() const { return _ring.size(); }
+    uint64_t Total() const { return _next; }      // events ever pushed
+    // i-th retained event, 0 = oldest
+    const RobotsEvent &At(size_t i) const { return _ring[(_next - Size() + i) & _mask]; }
+
+    // format one event as a log line; returns the length written
+    int Format(const RobotsEvent &e, const Arena &arena, char *buf, size_t size) const;
+    std::string Text(const RobotsEvent &e, const Arena &arena) const;
+
+private:
+    std::vector<RobotsEvent> _ring;
+    uint64_t _next = 0;
+    size_t _mask = 0;
+    std::vector<std::string> _notes;
+};
+
+// ===== Per-bot match statistics =====
+// Tallied from the same events as they are emitted (Arena::stats): one
+// switch per event while attached, nothing otherwise. Attach before
+// RobotsMatch::Setup, which sizes it to the roster.
+struct RobotsBotStats {
+    int32_t damageDealt = 0;
+    int32_t damageTaken = 0;
+    int32_t shotsFired = 0;
+    int32_t shotsMissed = 0;
+    int32_t kills = 0;
+    int32_t tilesMoved = 0;
+    int32_t signals = 0;
+};
+
+struct RobotsMatchStats {
+    std::vector<RobotsBotStats> bots;
+
+    void Reset(size_t count) { bots.assign(count, RobotsBotStats()); }
+    void Count(const RobotsEvent &e)
+    {
+        if (e.actor < 0 || e.actor >= (int32_t)bots.size()) return;
+        RobotsBotStats &a = bots[e.actor];
+        switch (e.type) {
+            case EV_MOVE: a.tilesMoved += e.value; break;
+            case EV_HIT:
+                a.shotsFired++;
+                a.damageDealt++;
+                if (e.target >= 0 && e.target < (int32_t)bots.size()) bots[e.target].damageTaken++;
+                break;
+            case EV_DESTROYED: a.kills++; break;
+            case EV_MISS: a.shotsFired++; a.shotsMissed++; break;
+            case EV_SIGNAL: a.signals++; break;
+            default: break;
+        }
+    }
+};
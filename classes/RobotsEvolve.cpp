@@ -0,0 +1,622 @@
+#include "RobotsEvolve.h"
+#include "RobotsMatch.h"
+#include <cstdio>
+#include <sstream>
+
+// ===== Gene helpers =====
+static bool isCondition(int op) { return op >= OP_IF_ENEMY && op <= OP_IF_NEAR_EDGE; }
+static bool isAction(int op) { return (op >= OP_WAIT && op <= OP_TURN_RANDOM) || op == OP_MOVE_TOWARD; }
+
+// what each op charges, as in the DSL macros
+static int actionCost(const GeneNode &n)
+{
+    switch (n.op) {
+        case OP_MOVE: return COST_MOVE * n.arg;
+        case OP_TURN: case OP_TURN_SCAN: case OP_TURN_AWAY: case OP_TURN_RANDOM: return COST_TURN;
+        case OP_ATTACK: case OP_ATTACK_SCAN: return COST_ATTACK;
+        case OP_SIGNAL: return COST_SIGNAL;
+        case OP_SCAN: return COST_SCAN;
+        case OP_MOVE_TOWARD: return COST_MOVE_TOWARD;
+        default: return COST_WAIT;
+    }
+}
+
+// operand range the generator draws from; {0,0} for ops without one
+static std::pair<int,int> argRange(int op)
+{
+    switch (op) {
+        case OP_MOVE: return {1, 3};
+        case OP_TURN: case OP_ATTACK: case OP_IF_ENEMY: return {0, 7};
+        case OP_SIGNAL: return {0, 3};
+        case OP_IF_TURN_LESS: return {1, MAX_TURNS};
+        case OP_IF_SCAN_LE: return {1, SCAN_RANGE};
+        case OP_IF_NEAR_SIGNAL: return {1, 6};
+        case OP_IF_HP_LE: return {1, START_HP};
+        case OP_IF_NEAR_EDGE: return {0, 3};
+        case OP_MOVE_TOWARD: return {0, FLOW_TARGET_COUNT - 1};
+        default: return {0, 0};
+    }
+}
+
+int GenomeCost(const RobotGenome &genome)
+{
+    int cost = 0;
+    for (const GeneNode &n : genome) {
+        cost += isCondition(n.op) ? GenomeCost(n.body) : actionCost(n);
+    }
+    return cost;
+}
+
+int GenomeNodes(const RobotGenome &genome)
+{
+    int nodes = 0;
+    for (const GeneNode &n : genome) nodes += 1 + GenomeNodes(n.body);
+    return nodes;
+}
+
+int GenomeDepth(const RobotGenome &genome)
+{
+    int depth = 0;
+    for (const GeneNode &n : genome) {
+        if (isCondition(n.op)) depth = std::max(depth, 1 + GenomeDepth(n.body));
+    }
+    return depth;
+}
+
+static void writeGenome(const RobotGenome &genome, std::string &out)
+{
+    for (const GeneNode &n : genome) {
+        if (!out.empty() && out.back() != '{') out += ' ';
+        out += std::to_string(n.op) + ":" + std::to_string(n.arg);
+        if (isCondition(n.op)) {
+            out += '{';
+            writeGenome(n.body, out);
+            out += '}';
+        }
+    }
+}
+
+std::string GenomeToString(const RobotGenome &genome)
+{
+    std::string out;
+    writeGenome(genome, out);
+    return out;
+}
+
+static bool readGenome(const char *&p, RobotGenome &block, int depth)
+{
+    while (true) {
+        while (*p == ' ') p++;
+        if (*p == 0 || *p == '}') return true;
+        char *end = nullptr;
+        GeneNode n;
+        n.op = (int)strtol(p, &end, 10);
+        if (end == p || *end != ':') return false;
+        p = end + 1;
+        n.arg = (int)strtol(p, &end, 10);
+        if (end == p || !(isAction(n.op) || isCondition(n.op)) || !OperandInRange(n.op, n.arg)) return false;
+        p = end;
+        if (isCondition(n.op)) {
+            if (*p != '{' || depth > 64) return false;
+            p++;
+            if (!readGenome(p, n.body, depth + 1) || *p != '}') return false;
+            p++;
+        }
+        block.push_back(std::move(n));
+    }
+}
+
+bool GenomeFromString(const std::string &text, RobotGenome &genome)
+{
+    genome.clear();
+    const char *p = text.c_str();
+    return readGenome(p, genome, 0) && *p == 0;
+}
+
+// ===== Source export =====
+static const char *directionName(int d)
+{
+    static const char *names[8] = {"NORTH", "EAST", "SOUTH", "WEST", "NORTHEAST", "SOUTHEAST", "SOUTHWEST", "NORTHWEST"};
+    return d >= 0 && d < 8 ? names[d] : nullptr;
+}
+
+static const char *targetName(int t)
+{
+    static const char *names[FLOW_TARGET_COUNT] = {"TOWARD_ENEMY", "TOWARD_SIGNAL", "TOWARD_CENTER"};
+    return t >= 0 && t < FLOW_TARGET_COUNT ? names[t] : nullptr;
+}
+
+static std::string operand(int op, int arg)
+{
+    if ((op == OP_TURN || op == OP_ATTACK || op == OP_IF_ENEMY) && directionName(arg)) return directionName(arg);
+    if (op == OP_MOVE_TOWARD && targetName(arg)) return targetName(arg);
+    return std::to_string(arg);
+}
+
+static void writeSource(const RobotGenome &genome, int indent, std::string &out)
+{
+    std::string pad(indent * 4, ' ');
+    for (const GeneNode &n : genome) {
+        std::string a = operand(n.op, n.arg);
+        switch (n.op) {
+            case OP_WAIT:           out += pad + "WAIT_();\n"; break;
+            case OP_MOVE:           out += pad + "MOVE(" + a + ");\n"; break;
+            case OP_TURN:           out += pad + "TURN(" + a + ");\n"; break;
+            case OP_ATTACK:         out += pad + "ATTACK(" + a + ");\n"; break;
+            case OP_SIGNAL:         out += pad + "SIGNAL(" + a + ");\n"; break;
+            case OP_ATTACK_SCAN:    out += pad + "ATTACK_SCAN();\n"; break;
+            case OP_SCAN:           out += pad + "SCAN();\n"; break;
+            case OP_TURN_SCAN:      out += pad + "TURN_SCAN();\n"; break;
+            case OP_TURN_AWAY:      out += pad + "TURN_AWAY();\n"; break;
+            case OP_TURN_RANDOM:    out += pad + "TURN_RANDOM();\n"; break;
+            case OP_MOVE_TOWARD:    out += pad + "MOVE_TOWARD(" + a + ");\n"; break;
+            case OP_IF_ENEMY:       out += pad + "IF_ENEMY(" + a + ") {\n"; break;
+            case OP_IF_TURN_LESS:   out += pad + "IF_TURN_LT(" + a + ") {\n"; break;
+            case OP_IF_SEEN:        out += pad + "IF_SEEN() {\n"; break;
+            case OP_IF_SCAN_LE:     out += pad + "IF_SCAN_LE(" + a + ") {\n"; break;
+            case OP_IF_NEAR_SIGNAL: out += pad + "IF_NEAR_SIGNAL(" + a + ") {\n"; break;
+            case OP_IF_DAMAGED:     out += pad + "IF_DAMAGED() {\n"; break;
+            case OP_IF_HP_LE:       out += pad + "IF_HP_LE(" + a + ") {\n"; break;
+            case OP_IF_CAN_ATTACK:  out += pad + "IF_CAN_ATTACK() {\n"; break;
+            case OP_IF_NEAR_EDGE:   out += pad + "IF_NEAR_EDGE(" + a + ") {\n"; break;
+        }
+        if (isCondition(n.op)) {
+            writeSource(n.body, indent + 1, out);
+            out += pad + "}\n";
+        }
+    }
+}
+
+std::string GenomeBody(const RobotGenome &genome, int indent)
+{
+    std::string out;
+    writeSource(genome, indent, out);
+    return out;
+}
+
+std::string GenomeSource(const RobotGenome &genome, const std::string &name)
+{
+    std::string out;
+    out += "// evolved: script cost " + std::to_string(GenomeCost(genome)) + "/" + std::to_string(MAX_SCRIPT_COST) + "\n";
+    out += "// genome " + GenomeToString(genome) + "\n";
+    out += "struct " + name + " : RobotBase {\n";
+    out += "    " + name + "(){ name=\"" + name + "\"; }\n";
+    out += "    int SetupRobot() override;\n";
+    out += "};\n\n";
+    out += "int " + name + "::SetupRobot() {\n";
+    out += GenomeBody(genome, 1);
+    out += "    return Finalize();\n";
+    out += "}\n";
+    return out;
+}
+
+// ===== GenomeBot =====
+int GenomeBot::SetupRobot()
+{
+    if (genome) emit(*genome);
+    return Finalize();
+}
+
+// the DSL macros themselves, so the p-code and script_cost are exactly what
+// the exported source produces
+void GenomeBot::emit(const RobotGenome &block)
+{
+    for (const GeneNode &n : block) {
+        switch (n.op) {
+            case OP_WAIT:           WAIT_(); break;
+            case OP_MOVE:           MOVE(n.arg); break;
+            case OP_TURN:           TURN(n.arg); break;
+            case OP_ATTACK:         ATTACK(n.arg); break;
+            case OP_SIGNAL:         SIGNAL(n.arg); break;
+            case OP_ATTACK_SCAN:    ATTACK_SCAN(); break;
+            case OP_SCAN:           SCAN(); break;
+            case OP_TURN_SCAN:      TURN_SCAN(); break;
+            case OP_TURN_AWAY:      TURN_AWAY(); break;
+            case OP_TURN_RANDOM:    TURN_RANDOM(); break;
+            case OP_MOVE_TOWARD:    MOVE_TOWARD(n.arg); break;
+            case OP_IF_ENEMY:       IF_ENEMY(n.arg) { emit(n.body); } break;
+            case OP_IF_TURN_LESS:   IF_TURN_LT(n.arg) { emit(n.body); } break;
+            case OP_IF_SEEN:        IF_SEEN() { emit(n.body); } break;
+            case OP_IF_SCAN_LE:     IF_SCAN_LE(n.arg) { emit(n.body); } break;
+            case OP_IF_NEAR_SIGNAL: IF_NEAR_SIGNAL(n.arg) { emit(n.body); } break;
+            case OP_IF_DAMAGED:     IF_DAMAGED() { emit(n.body); } break;
+            case OP_IF_HP_LE:       IF_HP_LE(n.arg) { emit(n.body); } break;
+            case OP_IF_CAN_ATTACK:  IF_CAN_ATTACK() { emit(n.body); } break;
+            case OP_IF_NEAR_EDGE:   IF_NEAR_EDGE(n.arg) { emit(n.body); } break;
+        }
+    }
+}
+
+// ===== RobotsEvolution =====
+namespace {
+    // a block of statements somewhere in a genome, and its IF nesting
+    struct Site {
+        RobotGenome *block;
+        int depth;
+    };
+
+    void collectSites(RobotGenome &block, int depth, std::vector<Site> &out)
+    {
+        out.push_back({&block, depth});
+        for (GeneNode &n : block) {
+            if (isCondition(n.op)) collectSites(n.body, depth + 1, out);
+        }
+    }
+
+    // one evaluation game from the evolved bot's seat
+    struct GameOutcome {
+        int result = 0;         // 1 win, 0 draw, -1 loss
+        double margin = 0.0;    // own hp minus mean opponent hp, in start-hp units
+    };
+}
+
+static const int ACTION_OPS[] = {OP_MOVE, OP_TURN, OP_ATTACK, OP_SIGNAL, OP_ATTACK_SCAN, OP_SCAN,
+                                 OP_TURN_SCAN, OP_TURN_AWAY, OP_TURN_RANDOM, OP_MOVE_TOWARD};
+static const int CONDITION_OPS[] = {OP_IF_ENEMY, OP_IF_TURN_LESS, OP_IF_SEEN, OP_IF_SCAN_LE, OP_IF_NEAR_SIGNAL,
+                                    OP_IF_DAMAGED, OP_IF_HP_LE, OP_IF_CAN_ATTACK, OP_IF_NEAR_EDGE};
+
+RobotsEvolution::RobotsEvolution(std::vector<RobotEntry> opponents, const EvolveOptions &options)
+    : _opponents(std::move(opponents)), _options(options), _pool(options.threads)
+{
+    _options.population = std::max(_options.population, 2);
+    _options.rounds = std::max(_options.rounds, 1);
+    _options.elite = std::clamp(_options.elite, 0, _options.population - 1);
+    _options.tournament = std::max(_options.tournament, 1);
+    _options.maxNodes = std::max(_options.maxNodes, 1);
+    _options.maxDepth = std::max(_options.maxDepth, 0);
+    _rng.Seed(_options.seed);
+}
+
+GeneNode RobotsEvolution::randomAction()
+{
+    GeneNode n;
+    n.op = ACTION_OPS[_rng.Range(0, (int)(sizeof(ACTION_OPS) / sizeof(ACTION_OPS[0])) - 1)];
+    auto range = argRange(n.op);
+    n.arg = _rng.Range(range.first, range.second);
+    return n;
+}
+
+GeneNode RobotsEvolution::randomCondition()
+{
+    GeneNode n;
+    n.op = CONDITION_OPS[_rng.Range(0, (int)(sizeof(CONDITION_OPS) / sizeof(CONDITION_OPS[0])) - 1)];
+    auto range = argRange(n.op);
+    n.arg = _rng.Range(range.first, range.second);
+    return n;
+}
+
+bool RobotsEvolution::valid(const RobotGenome &genome) const
+{
+    return !genome.empty() && GenomeCost(genome) <= MAX_SCRIPT_COST && GenomeNodes(genome) <= _options.maxNodes &&
+           GenomeDepth(genome) <= _options.maxDepth;
+}
+
+RobotGenome RobotsEvolution::randomGenome()
+{
+    while (true) {
+        RobotGenome genome;
+        int statements = _rng.Range(2, 6);
+        for (int s = 0; s < statements; ++s) {
+            if (_options.maxDepth > 0 && _rng.Range(0, 2) == 0) {
+                GeneNode cond = randomCondition();
+                int body = _rng.Range(1, 3);
+                for (int b = 0; b < body; ++b) cond.body.push_back(randomAction());
+                genome.push_back(std::move(cond));
+            } else {
+                genome.push_back(randomAction());
+            }
+        }
+        // over budget: drop trailing statements until it fits
+        while (!genome.empty() && !valid(genome)) genome.pop_back();
+        if (!genome.empty()) return genome;
+    }
+}
+
+RobotGenome RobotsEvolution::mutate(const RobotGenome &parent)
+{
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        RobotGenome child = parent;
+        std::vector<Site> sites;
+        collectSites(child, 0, sites);
+        Site site = sites[_rng.Range(0, (int)sites.size() - 1)];
+        RobotGenome &block = *site.block;
+        int size = (int)block.size();
+
+        switch (_rng.Range(0, 5)) {
+            case 0: {   // replace a statement's op (an IF keeps its body)
+                if (size == 0) continue;
+                GeneNode &n = block[_rng.Range(0, size - 1)];
+                GeneNode r = isCondition(n.op) ? randomCondition() : randomAction();
+                n.op = r.op;
+                n.arg = r.arg;
+                break;
+            }
+            case 1: {   // new operand
+                if (size == 0) continue;
+                GeneNode &n = block[_rng.Range(0, size - 1)];
+                auto range = argRange(n.op);
+                if (range.first == range.second) continue;
+                n.arg = _rng.Range(range.first, range.second);
+                break;
+            }
+            case 2: {   // insert an action or a one-statement IF
+                GeneNode n;
+                if (site.depth < _options.maxDepth && _rng.Range(0, 3) == 0) {
+                    n = randomCondition();
+                    n.body.push_back(randomAction());
+                } else {
+                    n = randomAction();
+                }
+                block.insert(block.begin() + _rng.Range(0, size), std::move(n));
+                break;
+            }
+            case 3: {   // delete a statement
+                if (size == 0) continue;
+                block.erase(block.begin() + _rng.Range(0, size - 1));
+                break;
+            }
+            case 4: {   // wrap up to three statements in a new IF
+                if (size == 0) continue;
+                int first = _rng.Range(0, size - 1);
+                int last = _rng.Range(first, std::min(size - 1, first + 2));
+                GeneNode cond = randomCondition();
+                cond.body.assign(block.begin() + first, block.begin() + last + 1);
+                block.erase(block.begin() + first, block.begin() + last + 1);
+                block.insert(block.begin() + first, std::move(cond));
+                break;
+            }
+            default: {  // unwrap an IF into its parent block
+                std::vector<int> ifs;
+                for (int i = 0; i < size; ++i) {
+                    if (isCondition(block[i].op)) ifs.push_back(i);
+                }
+                if (ifs.empty()) continue;
+                int i = ifs[_rng.Range(0, (int)ifs.size() - 1)];
+                RobotGenome body = std::move(block[i].body);
+                block.erase(block.begin() + i);
+                block.insert(block.begin() + i, body.begin(), body.end());
+                break;
+            }
+        }
+        if (valid(child)) return child;
+    }
+    return parent;
+}
+
+RobotGenome RobotsEvolution::crossover(const RobotGenome &a, const RobotGenome &b)
+{
+    for (int attempt = 0; attempt < 20; ++attempt) {
+        RobotGenome child = a;
+        RobotGenome donor = b;
+        std::vector<Site> into, from;
+        collectSites(child, 0, into);
+        collectSites(donor, 0, from);
+        RobotGenome &dst = *into[_rng.Range(0, (int)into.size() - 1)].block;
+        RobotGenome &src = *from[_rng.Range(0, (int)from.size() - 1)].block;
+
+        // swap a run of up to three statements for one from the other parent
+        int at = _rng.Range(0, (int)dst.size());
+        int cut = _rng.Range(0, std::min(3, (int)dst.size() - at));
+        int take = _rng.Range(0, (int)src.size());
+        int len = _rng.Range(0, std::min(3, (int)src.size() - take));
+        if (cut == 0 && len == 0) continue;
+        dst.erase(dst.begin() + at, dst.begin() + at + cut);
+        dst.insert(dst.begin() + at, src.begin() + take, src.begin() + take + len);
+        if (valid(child)) return child;
+    }
+    return a;
+}
+
+const EvolveIndividual &RobotsEvolution::select()
+{
+    const EvolveIndividual *best = nullptr;
+    for (int k = 0; k < _options.tournament; ++k) {
+        const EvolveIndividual &c = _population[_rng.Range(0, (int)_population.size() - 1)];
+        if (!best || c.fitness > best->fitness) best = &c;
+    }
+    return *best;
+}
+
+void RobotsEvolution::Initialize()
+{
+    _population.clear();
+    _generation = 0;
+    for (int i = 0; i < _options.population; ++i) {
+        EvolveIndividual ind;
+        ind.genome = randomGenome();
+        _population.push_back(std::move(ind));
+    }
+}
+
+int RobotsEvolution::MatchesPerIndividual() const
+{
+    int lineups = 2 * (int)_opponents.size() + (_options.freeForAll && _opponents.size() > 1 ? 1 : 0);
+    return lineups * _options.rounds;
+}
+
+void RobotsEvolution::Evaluate()
+{
+    // lineups from the evolved bot's point of view; seat -1 is the evolved bot
+    std::vector<std::vector<int>> lineups;
+    for (int o = 0; o < (int)_opponents.size(); ++o) {
+        lineups.push_back({-1, o});
+        lineups.push_back({o, -1});
+    }
+    if (_options.freeForAll && _opponents.size() > 1) {
+        std::vector<int> all = {-1};
+        for (int o = 0; o < (int)_opponents.size(); ++o) all.push_back(o);
+        lineups.push_back(all);
+    }
+    std::vector<std::vector<int>> games;        // seat order of each game
+    for (auto &lineup : lineups) {
+        for (int r = 0; r < _options.rounds; ++r) {
+            std::vector<int> seats(lineup.size());
+            for (size_t s = 0; s < lineup.size(); ++s) seats[s] = lineup[(s + (lineup.size() > 2 ? r : 0)) % lineup.size()];
+            games.push_back(seats);
+        }
+    }
+
+    // every individual faces the same seeds this generation
+    uint64_t base = _options.seed ^ ((uint64_t)(_generation + 1) * 0x9e3779b97f4a7c15ULL);
+    size_t count = _population.size();
+    std::vector<std::shared_ptr<const RobotGenome>> genomes;
+    for (auto &ind : _population) genomes.push_back(std::make_shared<const RobotGenome>(ind.genome));
+    std::vector<GameOutcome> outcomes(count * games.size());
+
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t g = 0; g < games.size(); ++g) {
+            _pool.Submit([&, i, g] {
+                const std::vector<int> &seats = games[g];
+                std::vector<std::unique_ptr<RobotBase>> bots;
+                int self = 0;
+                for (size_t s = 0; s < seats.size(); ++s) {
+                    if (seats[s] < 0) {
+                        self = (int)s;
+                        bots.emplace_back(std::make_unique<GenomeBot>(genomes[i], "Evolved"));
+                    } else {
+                        bots.emplace_back(_opponents[seats[s]].make());
+                    }
+                }
+                RobotsMatch match;
+                match.Setup(std::move(bots), base + g);
+                match.Play();
+
+                GameOutcome &out = outcomes[i * games.size() + g];
+                int winner = match.Winner();
+                out.result = winner == self ? 1 : (winner == -1 && match.arena.bots[self].alive ? 0 : -1);
+                double others = 0.0;
+                for (size_t s = 0; s < match.arena.bots.size(); ++s) {
+                    if ((int)s != self) others += std::max(match.arena.bots[s].hp, 0);
+                }
+                others /= std::max<size_t>(match.arena.bots.size() - 1, 1);
+                out.margin = (std::max(match.arena.bots[self].hp, 0) - others) / match.arena.cfg.startHp;
+            });
+        }
+    }
+    _pool.Wait();
+    _matchesPlayed += (long long)outcomes.size();
+
+    // 3 points a win, 1 a draw; hp margin only separates equal records
+    for (size_t i = 0; i < count; ++i) {
+        EvolveIndividual &ind = _population[i];
+        ind.wins = ind.draws = ind.losses = 0;
+        double points = 0.0, margin = 0.0;
+        for (size_t g = 0; g < games.size(); ++g) {
+            const GameOutcome &out = outcomes[i * games.size() + g];
+            if (out.result > 0) { ind.wins++; points += 3.0; }
+            else if (out.result == 0) { ind.draws++; points += 1.0; }
+            else ind.losses++;
+            margin += out.margin;
+        }
+        ind.fitness = (points + 0.1 * margin) / (double)games.size();
+    }
+    std::stable_sort(_population.begin(), _population.end(),
+                     [](const EvolveIndividual &a, const EvolveIndividual &b) { return a.fitness > b.fitness; });
+}
+
+void RobotsEvolution::Breed()
+{
+    std::vector<EvolveIndividual> next;
+    for (int e = 0; e < _options.elite && e < (int)_population.size(); ++e) {
+        EvolveIndividual elite;
+        elite.genome = _population[e].genome;
+        next.push_back(std::move(elite));
+    }
+    while ((int)next.size() < _options.population) {
+        EvolveIndividual child;
+        if (_rng.Next() < (uint32_t)(_options.crossoverRate * 4294967295.0)) {
+            const EvolveIndividual &a = select();
+            const EvolveIndividual &b = select();
+            child.genome = crossover(a.genome, b.genome);
+            if (_rng.Range(0, 2) == 0) child.genome = mutate(child.genome);
+        } else {
+            child.genome = mutate(select().genome);
+        }
+        next.push_back(std::move(child));
+    }
+    _population = std::move(next);
+    _generation++;
+}
+
+// ===== Checkpoints =====
+// Plain text: a header of key/value lines, then one individual per line as
+// "fitness wins draws losses genome".
+static constexpr const char *CHECKPOINT_MAGIC = "robots-evolve 1";
+
+bool RobotsEvolution::SaveCheckpoint(const std::string &path, std::string *error) const
+{
+    // write aside and rename, so a crash never leaves a half-written checkpoint
+    std::string tmp = path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "w");
+    if (!f) {
+        if (error) *error = "cannot write " + tmp;
+        return false;
+    }
+    fprintf(f, "%s\n", CHECKPOINT_MAGIC);
+    fprintf(f, "seed %llu\n", (unsigned long long)_options.seed);
+    fprintf(f, "generation %d\n", _generation);
+    fprintf(f, "rng %llu %llu\n", (unsigned long long)_rng.state, (unsigned long long)_rng.inc);
+    fprintf(f, "matches %lld\n", _matchesPlayed);
+    fprintf(f, "population %zu\n", _population.size());
+    for (const EvolveIndividual &ind : _population) {
+        fprintf(f, "%.17g %d %d %d %s\n", ind.fitness, ind.wins, ind.draws, ind.losses, GenomeToString(ind.genome).c_str());
+    }
+    bool ok = fclose(f) == 0;
+    if (ok) ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+    if (!ok && error) *error = "cannot write " + path;
+    return ok;
+}
+
+bool RobotsEvolution::LoadCheckpoint(const std::string &path, std::string *error)
+{
+    auto fail = [&](const std::string &why) {
+        if (error) *error = why;
+        return false;
+    };
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f) return fail("cannot open " + path);
+    std::string text;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+    fclose(f);
+
+    std::istringstream in(text);
+    std::string line, key;
+    if (!std::getline(in, line) || line != CHECKPOINT_MAGIC) return fail("not an evolution checkpoint");
+    unsigned long long seed = 0, state = 0, inc = 0;
+    long long matches = 0;
+    int generation = 0;
+    size_t size = 0;
+    if (!(in >> key >> seed) || key != "seed" || !(in >> key >> generation) || key != "generation" ||
+        !(in >> key >> state >> inc) || key != "rng" || !(in >> key >> matches) || key != "matches" ||
+        !(in >> key >> size) || key != "population" || size < 2) {
+        return fail("bad checkpoint header");
+    }
+    std::getline(in, line);
+
+    std::vector<EvolveIndividual> population;
+    while (population.size() < size && std::getline(in, line)) {
+        std::istringstream row(line);
+        EvolveIndividual ind;
+        std::string genome;
+        if (!(row >> ind.fitness >> ind.wins >> ind.draws >> ind.losses) || !std::getline(row, genome) ||
+            !GenomeFromString(genome, ind.genome) || ind.genome.empty()) {
+            return fail("bad genome on line " + std::to_string(population.size() + 7));
+        }
+        // the same limits a bred genome meets, so a checkpoint cannot field an over-budget bot
+        if (!valid(ind.genome)) return fail("genome on line " + std::to_string(population.size() + 7) + " exceeds the script cost, node or depth limit");
+        population.push_back(std::move(ind));
+    }
+    if (population.size() != size) return fail("checkpoint is truncated");
+
+    _options.seed = seed;
+    _options.population = (int)size;
+    _options.elite = std::min(_options.elite, _options.population - 1);
+    _generation = generation;
+    _rng.state = state;
+    _rng.inc = inc;
+    _matchesPlayed = matches;
+    _population = std::move(population);
+    return true;
+}
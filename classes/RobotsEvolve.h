@@ -0,0 +1,115 @@
+#pragma once
+
+#include "RobotsArena.h"
+#include "WorkStealingPool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// ===== Evolved bots =====
+// Genetic programming over the bot DSL. A genome is the statement tree a
+// SetupRobot() body would contain: actions (OP_MOVE..OP_TURN_RANDOM and
+// OP_MOVE_TOWARD, with their operand) and IF_* blocks with a body. GenomeBot emits it through the
+// same macros a hand-written bot uses, so every genome is valid p-code with
+// the macro script_cost, and GenomeSource prints it back as that C++ body.
+//
+// There is no ELSE gene: ELSE() bodies never reach the p-code (the IF
+// macro's `if` is always taken), so an evolved ELSE could not be exported
+// faithfully.
+struct GeneNode {
+    int op = OP_WAIT;               // action OpCode or OP_IF_* condition
+    int arg = 0;                    // operand, 0 for ops that take none
+    std::vector<GeneNode> body;     // IF_* only
+};
+using RobotGenome = std::vector<GeneNode>;
+
+int GenomeCost(const RobotGenome &genome);     // script_cost the macros charge
+int GenomeNodes(const RobotGenome &genome);
+int GenomeDepth(const RobotGenome &genome);    // IF nesting, 0 = no IFs
+
+// one-line form used by checkpoints: "op:arg" per action, "op:arg{ ... }" per IF
+std::string GenomeToString(const RobotGenome &genome);
+// false on malformed text or an operand outside OperandInRange
+bool GenomeFromString(const std::string &text, RobotGenome &genome);
+
+// C++ source for a RobotBase subclass called `name` whose SetupRobot()
+// compiles to exactly the genome's p-code
+std::string GenomeSource(const RobotGenome &genome, const std::string &name);
+// just the statements, one per line, `indent` levels deep (also a valid
+// .bot script body, see RobotsScript.h)
+std::string GenomeBody(const RobotGenome &genome, int indent = 0);
+
+struct GenomeBot : RobotBase {
+    GenomeBot(std::shared_ptr<const RobotGenome> g, const std::string &botName) : genome(std::move(g)) { name = botName; }
+    int SetupRobot() override;
+
+    std::shared_ptr<const RobotGenome> genome;
+private:
+    void emit(const RobotGenome &block);
+};
+
+// ===== RobotsEvolution: the search =====
+// Each generation every individual plays 1v1 against every opponent (in both
+// seats) and, optionally, the free-for-all with all of them, `rounds` times
+// per lineup. All individuals of a generation face the same match seeds.
+// Matches run on a WorkStealingPool; breeding runs on the calling thread
+// from a seeded RobotsRng, so a run replays exactly whatever the thread count.
+struct EvolveOptions {
+    int population = 64;
+    int rounds = 4;                 // matches per lineup per individual
+    unsigned threads = 0;           // 0 = one per core
+    uint64_t seed = 1;
+    bool freeForAll = true;
+    int elite = 2;                  // best individuals copied unchanged
+    int tournament = 3;             // selection tournament size
+    double crossoverRate = 0.7;     // otherwise the child is a mutated copy
+    int maxNodes = 24;
+    int maxDepth = 3;
+};
+
+struct EvolveIndividual {
+    RobotGenome genome;
+    double fitness = 0.0;           // match points per game plus a small hp-margin tie-break
+    int wins = 0, draws = 0, losses = 0;
+};
+
+class RobotsEvolution
+{
+public:
+    RobotsEvolution(std::vector<RobotEntry> opponents, const EvolveOptions &options);
+
+    // random starting population, generation 0
+    void Initialize();
+    // score every individual; the population ends up sorted best first
+    void Evaluate();
+    // replace the population with the next generation
+    void Breed();
+
+    int Generation() const { return _generation; }
+    const std::vector<EvolveIndividual> &Population() const { return _population; }
+    const EvolveOptions &Options() const { return _options; }
+    int MatchesPerIndividual() const;
+    unsigned Threads() const { return _pool.Size(); }
+    long long MatchesPlayed() const { return _matchesPlayed; }
+
+    // the population (evaluated or not), generation and RNG state as text
+    bool SaveCheckpoint(const std::string &path, std::string *error = nullptr) const;
+    bool LoadCheckpoint(const std::string &path, std::string *error = nullptr);
+
+private:
+    RobotGenome randomGenome();
+    RobotGenome mutate(const RobotGenome &parent);
+    RobotGenome crossover(const RobotGenome &a, const RobotGenome &b);
+    GeneNode randomAction();
+    GeneNode randomCondition();
+    bool valid(const RobotGenome &genome) const;
+    const EvolveIndividual &select();
+
+    std::vector<RobotEntry> _opponents;
+    EvolveOptions _options;
+    std::vector<EvolveIndividual> _population;
+    RobotsRng _rng;
+    int _generation = 0;
+    long long _matchesPlayed = 0;
+    WorkStealingPool _pool;
+};
@@ -0,0 +1,222 @@
+#include "RobotsMatch.h"
+#include "WorkStealingPool.h"
+#include <cstdio>
+
+// the flow fields a bot's MOVE_TOWARDs read, which simultaneous turns build
+// before planning
+static unsigned flowTargetsUsed(const RobotBase &bot)
+{
+    unsigned used = 0;
+    if (!bot.program) return used;
+    for (const RobotInstr &in : bot.program->instrs) {
+        if (in.op == OP_MOVE_TOWARD && in.arg >= 0 && in.arg < FLOW_TARGET_COUNT) used |= 1u << in.arg;
+    }
+    return used;
+}
+
+void RobotsMatch::Setup(std::vector<std::unique_ptr<RobotBase>> roster, uint64_t matchSeed, const ArenaConfig &config)
+{
+    bots = std::move(roster);
+    seed = matchSeed;
+    arena.cfg = config;
+    if (bots.size() > (size_t)config.width * config.height) {
+        bots.resize((size_t)config.width * config.height);
+    }
+    arena.bots.clear();
+    arena.bots.resize(bots.size());
+    arena.ClearSignals();
+    arena.rng.Seed(seed);
+    if (arena.stats) arena.stats->Reset(bots.size());
+
+    // Validate scripts & inject arena refs
+    arena.flowTargets = 0;
+    for(size_t i=0; i<bots.size(); ++i){
+        bots[i]->SetupRobot();
+        arena.flowTargets |= flowTargetsUsed(*bots[i]);
+        arena.bots[i].r = bots[i].get();
+        arena.bots[i].glyph = char('A'+(int)(i%26));
+        arena.bots[i].hp = arena.bots[i].last_hp = config.startHp;
+        bots[i]->A = &arena;
+        bots[i]->id = (int)i;
+        if (profiling) bots[i]->profile.reset(new RobotProfile());
+    }
+
+    placeBots();
+    arena.RebuildOccupancy();
+
+    turn = 0;
+    running = true;
+}
+
+void RobotsMatch::Setup(const std::vector<RobotEntry> &roster, uint64_t matchSeed, const ArenaConfig &config)
+{
+    std::vector<std::unique_ptr<RobotBase>> clones;
+    size_t count = config.botCount > 0 ? (size_t)config.botCount : roster.size();
+    count = std::min(count, (size_t)config.width * config.height);
+    if (!roster.empty()) {
+        for (size_t i = 0; i < count; ++i) {
+            clones.emplace_back(roster[i % roster.size()].make());
+        }
+    }
+    Setup(std::move(clones), matchSeed, config);
+}
+
+void RobotsMatch::placeBots()
+{
+    const int W = arena.cfg.width, H = arena.cfg.height;
+    size_t count = arena.bots.size();
+
+    // Interior lattice spawn pattern (spaced), randomized order each game (no edges)
+    std::vector<std::pair<int,int>> spawns;
+    for(int y=1; y<H-1; y+=2) {
+        for(int x=1; x<W-1; x+=3) {
+            spawns.push_back({x,y});
+        }
+    }
+    if (count <= spawns.size()) {
+        // Shuffle to avoid lining up on the same rows/columns each match
+        for (int i = (int)spawns.size() - 1; i > 0; --i) {
+            std::swap(spawns[i], spawns[arena.rng.Range(0, i)]);
+        }
+        for(size_t i=0; i<count; ++i){
+            arena.bots[i].x = spawns[i].first;
+            arena.bots[i].y = spawns[i].second;
+        }
+        return;
+    }
+
+    // Crowds that outgrow the lattice get distinct random cells, interior
+    // first and the whole board only once the interior is full
+    bool interior = W > 2 && H > 2 && count <= (size_t)(W-2)*(H-2);
+    int x0 = interior ? 1 : 0, y0 = interior ? 1 : 0;
+    int w = interior ? W-2 : W, h = interior ? H-2 : H;
+    size_t cells = (size_t)w*h;
+
+    if (count * 2 <= cells) {
+        // sparse: rejection-sample free cells
+        std::vector<char> taken(cells, 0);
+        for (size_t i = 0; i < count; ++i) {
+            int c;
+            do { c = arena.rng.Range(0, (int)cells-1); } while (taken[c]);
+            taken[c] = 1;
+            arena.bots[i].x = x0 + c % w;
+            arena.bots[i].y = y0 + c / w;
+        }
+    } else {
+        // dense: partial Fisher-Yates over every cell
+        std::vector<int> order(cells);
+        for (size_t c = 0; c < cells; ++c) order[c] = (int)c;
+        for (size_t i = 0; i < count; ++i) {
+            std::swap(order[i], order[arena.rng.Range((int)i, (int)cells-1)]);
+            arena.bots[i].x = x0 + order[i] % w;
+            arena.bots[i].y = y0 + order[i] / w;
+        }
+    }
+}
+
+bool RobotsMatch::Step()
+{
+    if (!running) {
+        return false;
+    }
+
+    turn++;
+    if (turn > arena.cfg.maxTurns) {
+        running = false;
+        return false;
+    }
+
+    arena.StartTurn();
+
+    if (arena.cfg.simultaneous) {
+        // every bot plans against the same board, so the order is free
+        arena.BeginPlanning();
+        const size_t n = arena.bots.size();
+        auto plan = [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                if (arena.bots[i].alive) bots[i]->Run(turn);
+            }
+        };
+        if (pool && n > PLAN_CHUNK) {
+            for (size_t begin = 0; begin < n; begin += PLAN_CHUNK) {
+                pool->Submit([&plan, begin, n] { plan(begin, std::min(begin + PLAN_CHUNK, n)); });
+            }
+            pool->Wait();
+        } else {
+            plan(0, n);
+        }
+        arena.ResolveTurn();
+    } else {
+        // Each alive bot takes a turn in id order (deterministic)
+        for(size_t i=0; i<arena.bots.size(); ++i){
+            if(!arena.bots[i].alive) continue;
+            bots[i]->Run(turn);
+        }
+    }
+
+    if (AliveCount() <= 1) {
+        running = false;
+    }
+    return running;
+}
+
+void RobotsMatch::Play()
+{
+    while (Step()) {
+    }
+}
+
+void RobotsMatch::Reset()
+{
+    arena = Arena();
+    bots.clear();
+    turn = 0;
+    running = false;
+}
+
+void RobotsMatch::SetProfiling(bool on)
+{
+    profiling = on;
+    for (auto &bot : bots) {
+        bot->profile.reset(on ? new RobotProfile() : nullptr);
+    }
+}
+
+std::string RobotsMatch::ProfileCsv() const
+{
+    std::string out = ROBOT_PROFILE_CSV_HEADER;
+    for (auto &bot : bots) {
+        if (bot->profile) AppendProfileCsv(out, bot->name + "#" + std::to_string(bot->id), *bot->profile);
+    }
+    return out;
+}
+
+bool RobotsMatch::SaveProfileCsv(const std::string &path) const
+{
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::string csv = ProfileCsv();
+    bool ok = fwrite(csv.data(), 1, csv.size(), f) == csv.size();
+    return fclose(f) == 0 && ok;
+}
+
+int RobotsMatch::AliveCount() const
+{
+    int alive = 0;
+    for (auto &b : arena.bots) {
+        if (b.alive) alive++;
+    }
+    return alive;
+}
+
+int RobotsMatch::Winner() const
+{
+    if (running) return -1;
+    int winner = -1;
+    for (size_t i=0; i<arena.bots.size(); ++i) {
+        if (!arena.bots[i].alive) continue;
+        if (winner != -1) return -1;
+        winner = (int)i;
+    }
+    return winner;
+}
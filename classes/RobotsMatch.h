@@ -0,0 +1,48 @@
+#pragma once
+
+#include "RobotsArena.h"
+
+class WorkStealingPool;
+
+// ===== RobotsMatch: one headless match (arena + one VM per bot) =====
+// Used by the Robots game for the on-screen match and by robots_sim for
+// offline runs, so both play by exactly the same rules.
+struct RobotsMatch {
+    Arena arena;
+    std::vector<std::unique_ptr<RobotBase>> bots;
+    int turn = 0;
+    bool running = false;
+    uint64_t seed = 0;      // replaying with the same seed and roster gives the same match
+    // simultaneous turns plan their bots on this pool when set (not owned;
+    // it must not be a pool this match itself runs on)
+    WorkStealingPool *pool = nullptr;
+    bool profiling = false;     // attach a RobotProfile to every bot in Setup()
+
+    // compile every script, inject arena refs and place bots on spawn points;
+    // bots beyond the number of board cells are dropped
+    void Setup(std::vector<std::unique_ptr<RobotBase>> roster, uint64_t matchSeed, const ArenaConfig &config = ArenaConfig());
+    void Setup(std::vector<std::unique_ptr<RobotBase>> roster) { Setup(std::move(roster), RandomSeed()); }
+    // same, cloning config.botCount bots round-robin from the roster factories
+    void Setup(const std::vector<RobotEntry> &roster, uint64_t matchSeed, const ArenaConfig &config);
+    // play one turn; returns false once the match is over
+    bool Step();
+    // play until one bot is left or the turn limit runs out
+    void Play();
+    // drop bots and arena state (including the event sink)
+    void Reset();
+
+    // attach (fresh) or drop every bot's RobotProfile, now and for later Setups
+    void SetProfiling(bool on);
+    // every bot's profile as CSV (see AppendProfileCsv), names suffixed #id
+    std::string ProfileCsv() const;
+    bool SaveProfileCsv(const std::string &path) const;
+
+    int AliveCount() const;
+    int Winner() const;     // index of the sole survivor, -1 if none
+    bool IsDraw() const { return !running && turn >= arena.cfg.maxTurns && AliveCount() > 1; }
+    int TurnsPlayed() const { return std::min(turn, arena.cfg.maxTurns); }
+
+private:
+    static constexpr size_t PLAN_CHUNK = 512;   // bots per pool task in simultaneous turns
+    void placeBots();
+};
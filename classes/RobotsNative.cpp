@@ -0,0 +1,18 @@
+#include "RobotsNative.h"
+
+template <typename P>
+static RobotEntry nativeEntry(const char *name, bool compiled)
+{
+    return RobotEntry{ name, [name, compiled]{ return std::unique_ptr<RobotBase>(std::make_unique<NativeBot<P>>(name, compiled)); } };
+}
+
+std::vector<RobotEntry> NativeClassRoster(bool compiled)
+{
+    using namespace robots_native;
+    std::vector<RobotEntry> v;
+    v.push_back(nativeEntry<PusherProgram>("Pusher", compiled));
+    v.push_back(nativeEntry<KamikazeProgram>("Kamikaze", compiled));
+    v.push_back(nativeEntry<ShyProgram>("Shy", compiled));
+    v.push_back(nativeEntry<HunterProgram>("Hunter", compiled));
+    return v;
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include "RobotsArena.h"
+#include <climits>
+#include <type_traits>
+
+// ===== Natively compiled bot programs =====
+// The same DSL as the macros, spelled as types, for fixed bots that play
+// millions of turns (the class roster as ladder opponents):
+//
+//   using PusherProgram = robots_native::Program<
+//       Scan, If<Seen, TurnScan, AttackScan>, Move<1>, Signal<1>>;
+//
+// NativeBot<P> emits P's p-code exactly as the macros would (so the
+// interpreter, the lowered program and script_cost are all unchanged; the
+// program is lowered once per type and shared by every instance) and
+// also installs a compiled Run: each statement is an inlined call straight
+// into Arena, with no dispatch and no operand decoding. Passing
+// compiled = false keeps it on the interpreter.
+//
+// Behaviour is identical to the interpreted program, including VM metering:
+// cycles count the instructions the optimized program would execute (WAIT
+// is free, IF and a SCAN fused into the following IF_SEEN/IF_SCAN_LE count
+// once, END counts one) and the instruction budget is checked where the VM
+// checks it, on taken branches. script_cost is a compile-time constant and
+// over-budget programs do not compile.
+//
+// There is no ELSE: the macros never emit ELSE() bodies, and a native ELSE
+// would behave differently from the p-code.
+namespace robots_native {
+
+struct Context {
+    Arena &A;
+    int id;
+    Arena::BotState &b;
+    int turn;
+    int cycles;
+    int budget;
+};
+
+// ----- actions -----
+struct Wait {
+    static constexpr int cost = COST_WAIT;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_WAIT); r.script_cost += cost; }
+    static bool Run(Context &) { return true; }     // dropped by the peephole pass
+};
+template <int N> struct Move {
+    static constexpr int cost = COST_MOVE * N;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_MOVE); r.code.push_back(N); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.Move(c.id, N); return true; }
+};
+template <int D> struct Turn {
+    static constexpr int cost = COST_TURN;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_TURN); r.code.push_back(D); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.Turn(c.id, D); return true; }
+};
+template <int D> struct Attack {
+    static constexpr int cost = COST_ATTACK;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_ATTACK); r.code.push_back(D); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.Attack(c.id, D); return true; }
+};
+template <int V> struct Signal {
+    static constexpr int cost = COST_SIGNAL;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_SIGNAL); r.code.push_back(V); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.Signal(c.id, V); return true; }
+};
+struct AttackScan {
+    static constexpr int cost = COST_ATTACK;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_ATTACK_SCAN); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.AttackScan(c.id); return true; }
+};
+struct Scan {
+    static constexpr int cost = COST_SCAN;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_SCAN); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.Scan(c.id); return true; }
+};
+struct TurnScan {
+    static constexpr int cost = COST_TURN;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_TURN_SCAN); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; if (c.b.scan_dir >= 0) c.A.Turn(c.id, c.b.scan_dir); return true; }
+};
+struct TurnAway {
+    static constexpr int cost = COST_TURN;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_TURN_AWAY); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; if (c.b.scan_dir >= 0) c.A.Turn(c.id, (c.b.scan_dir + 4) % 8); return true; }
+};
+struct TurnRandom {
+    static constexpr int cost = COST_TURN;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_TURN_RANDOM); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.Turn(c.id, c.A.RandomDirection(c.id)); return true; }
+};
+
+template <int T> struct MoveToward {
+    static constexpr int cost = COST_MOVE_TOWARD;
+    static void Emit(RobotBase &r) { r.code.push_back(OP_MOVE_TOWARD); r.code.push_back(T); r.script_cost += cost; }
+    static bool Run(Context &c) { c.cycles++; c.A.MoveToward(c.id, T); return true; }
+};
+
+// ----- conditions -----
+template <int D> struct Enemy {
+    static constexpr int op = OP_IF_ENEMY, arg = D;
+    static bool Test(Context &c) { return c.A.EnemyAdjacent(c.id, D); }
+};
+template <int T> struct TurnLt {
+    static constexpr int op = OP_IF_TURN_LESS, arg = T;
+    static bool Test(Context &c) { return c.turn < T; }
+};
+struct Seen {
+    static constexpr int op = OP_IF_SEEN, arg = 0;
+    static bool Test(Context &c) { return c.b.scan_dist > 0; }
+};
+template <int R> struct ScanLe {
+    static constexpr int op = OP_IF_SCAN_LE, arg = R;
+    static bool Test(Context &c) { return c.b.scan_dist > 0 && c.b.scan_dist <= R; }
+};
+template <int R> struct NearSignal {
+    static constexpr int op = OP_IF_NEAR_SIGNAL, arg = R;
+    static bool Test(Context &c) { return c.A.HasSignalNearby(c.id, R); }
+};
+struct Damaged {
+    static constexpr int op = OP_IF_DAMAGED, arg = 0;
+    static bool Test(Context &c) { return c.b.damaged_last_turn; }
+};
+template <int N> struct HpLe {
+    static constexpr int op = OP_IF_HP_LE, arg = N;
+    static bool Test(Context &c) { return c.b.hp <= N; }
+};
+struct CanAttack {
+    static constexpr int op = OP_IF_CAN_ATTACK, arg = 0;
+    static bool Test(Context &c) { return c.b.cooldown == 0; }
+};
+template <int R> struct NearEdge {
+    static constexpr int op = OP_IF_NEAR_EDGE, arg = R;
+    static bool Test(Context &c) {
+        int dx = std::min(c.b.x, c.A.cfg.width - 1 - c.b.x);
+        int dy = std::min(c.b.y, c.A.cfg.height - 1 - c.b.y);
+        return std::min(dx, dy) <= R;
+    }
+};
+
+// ----- blocks -----
+template <class... S> struct Seq;
+
+template <> struct Seq<> {
+    static constexpr int cost = 0;
+    static void Emit(RobotBase &) {}
+    static bool Run(Context &) { return true; }
+};
+
+template <class Cond, class... Body> struct If {
+    static constexpr int cost = Seq<Body...>::cost;
+    static void Emit(RobotBase &r) {
+        // the macros' own IF machinery, so jump targets are patched identically
+        RobotBase::IfBlock block{&r, (OpCode)Cond::op, Cond::arg};
+        Seq<Body...>::Emit(r);
+    }
+    static bool Run(Context &c) {
+        c.cycles++;
+        return Cond::Test(c) ? Seq<Body...>::Run(c) : Taken(c);
+    }
+    // the false branch is a VM jump: the budget is checked there
+    static bool Taken(Context &c) { return c.cycles <= c.budget; }
+};
+
+// SCAN directly followed by IF_SEEN / IF_SCAN_LE is one VM instruction
+template <class S> struct FusesWithScan : std::false_type {};
+template <class... Body> struct FusesWithScan<If<Seen, Body...>> : std::true_type {};
+template <int R, class... Body> struct FusesWithScan<If<ScanLe<R>, Body...>> : std::true_type {};
+template <class... Rest> struct NextFusesWithScan : std::false_type {};
+template <class Next, class... Rest> struct NextFusesWithScan<Next, Rest...> : FusesWithScan<Next> {};
+
+template <class S, class... Rest> struct Seq<S, Rest...> {
+    static constexpr int cost = S::cost + Seq<Rest...>::cost;
+    static void Emit(RobotBase &r) { S::Emit(r); Seq<Rest...>::Emit(r); }
+    static bool Run(Context &c) {
+        if constexpr (std::is_same_v<S, Scan> && NextFusesWithScan<Rest...>::value) {
+            c.A.Scan(c.id);         // counted by the IF
+        } else {
+            if (!S::Run(c)) return false;
+        }
+        return Seq<Rest...>::Run(c);
+    }
+};
+
+template <class... S> using Program = Seq<S...>;
+
+template <class P> void Run(RobotBase &bot, int turn)
+{
+    Arena &A = *bot.A;
+    Context c{A, bot.id, A.bots[bot.id], turn, 0, A.cfg.instructionBudget > 0 ? A.cfg.instructionBudget : INT_MAX};
+    if (!P::Run(c)) {
+        A.EndBotTurn(c.id, c.cycles, true);
+        return;
+    }
+    A.EndBotTurn(c.id, c.cycles + 1, false);    // + OP_END
+}
+
+} // namespace robots_native
+
+template <class P>
+struct NativeBot : RobotBase {
+    static_assert(P::cost <= MAX_SCRIPT_COST, "bot program exceeds MAX_SCRIPT_COST");
+
+    explicit NativeBot(const char *botName, bool compiled = true) : _compiled(compiled) { name = botName; }
+    int SetupRobot() override {
+        P::Emit(*this);
+        code.push_back(OP_END);
+        // the program is fixed, so every instance shares one lowered copy
+        static const std::shared_ptr<const RobotProgram> lowered = LowerProgram(code, script_cost);
+        program = lowered;
+        if (_compiled) native = &robots_native::Run<P>;
+        return script_cost;
+    }
+
+private:
+    bool _compiled;
+};
+
+// ===== Class roster as native programs =====
+// Same bots, same p-code as the macro versions in RobotsArena.cpp (checked by
+// robots_bench native); ELSE() bodies are left out as the macros leave them.
+namespace robots_native {
+using PusherProgram = Program<
+    Scan, If<Seen, TurnScan, AttackScan>, Move<1>, Signal<1>>;
+using KamikazeProgram = Program<
+    Scan, If<Seen, TurnScan, AttackScan, Move<1>>, Move<2>, Signal<1>>;
+using ShyProgram = Program<
+    Scan, If<ScanLe<5>, TurnAway, Move<2>, Signal<2>>>;
+using HunterProgram = Program<
+    Scan,
+    If<Damaged, TurnAway, Move<1>, Signal<2>>,
+    If<Seen, If<CanAttack, TurnScan, AttackScan>>,
+    If<NearEdge<1>, TurnRandom, Move<1>>>;
+}
+
+// the class roster with compiled programs (compiled = false: the same
+// NativeBot types on the interpreter)
+std::vector<RobotEntry> NativeClassRoster(bool compiled = true);
@@ -0,0 +1,417 @@
+#include "RobotsReplay.h"
+#include <cstdio>
+#include <cstring>
+
+static const char REPLAY_MAGIC[4] = {'R', 'B', 'R', 'P'};
+static constexpr uint32_t REPLAY_VERSION = 2;   // 2 added ArenaConfig::simultaneous
+static constexpr uint8_t RECORD_KEYFRAME = 'K';
+static constexpr uint8_t RECORD_DELTA = 'D';
+static constexpr uint8_t FLAG_RUNNING = 1;
+static constexpr uint8_t FLAG_RNG = 2;
+
+// header offsets of the fields Finish() patches
+static constexpr size_t LAST_TURN_AT = 16;
+static constexpr size_t INDEX_AT = 20;
+
+// ===== per-bot gameplay fields =====
+static constexpr int BOT_FIELDS = 11;
+
+static void packBot(const Arena::BotState &b, int32_t f[BOT_FIELDS])
+{
+    f[0] = b.x; f[1] = b.y; f[2] = b.dir; f[3] = b.hp; f[4] = b.last_hp;
+    f[5] = b.damaged_last_turn; f[6] = b.alive; f[7] = b.scan_dist; f[8] = b.scan_dir;
+    f[9] = b.cooldown; f[10] = b.signal;
+}
+
+static void unpackBot(const int32_t f[BOT_FIELDS], Arena::BotState &b)
+{
+    b.x = f[0]; b.y = f[1]; b.dir = f[2]; b.hp = f[3]; b.last_hp = f[4];
+    b.damaged_last_turn = f[5] != 0; b.alive = f[6] != 0; b.scan_dist = f[7]; b.scan_dir = f[8];
+    b.cooldown = f[9]; b.signal = f[10];
+}
+
+// ===== byte encoding =====
+static void putU8(std::vector<uint8_t> &out, uint8_t v) { out.push_back(v); }
+
+static void putU32(std::vector<uint8_t> &out, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+static void putU64(std::vector<uint8_t> &out, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+static void patchU32(std::vector<uint8_t> &out, size_t at, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i) out[at + i] = (uint8_t)(v >> (8 * i));
+}
+
+static void patchU64(std::vector<uint8_t> &out, size_t at, uint64_t v)
+{
+    for (int i = 0; i < 8; ++i) out[at + i] = (uint8_t)(v >> (8 * i));
+}
+
+static void putVarint(std::vector<uint8_t> &out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static void putSigned(std::vector<uint8_t> &out, int64_t v)
+{
+    putVarint(out, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+// bounds-checked reader; any overrun latches `ok` to false
+struct ReplayReader {
+    const uint8_t *data;
+    size_t size;
+    size_t pos = 0;
+    bool ok = true;
+
+    ReplayReader(const std::vector<uint8_t> &buf, size_t at = 0) : data(buf.data()), size(buf.size()), pos(at) {}
+
+    bool need(size_t n)
+    {
+        if (!ok || pos + n > size) ok = false;
+        return ok;
+    }
+    uint8_t u8()
+    {
+        return need(1) ? data[pos++] : 0;
+    }
+    uint32_t u32()
+    {
+        if (!need(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= (uint32_t)data[pos++] << (8 * i);
+        return v;
+    }
+    uint64_t u64()
+    {
+        if (!need(8)) return 0;
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= (uint64_t)data[pos++] << (8 * i);
+        return v;
+    }
+    uint64_t varint()
+    {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = u8();
+            v |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    int64_t sig()
+    {
+        uint64_t v = varint();
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+};
+
+// ===== RobotsSnapshot =====
+void RobotsSnapshot::Capture(const RobotsMatch &match)
+{
+    turn = match.turn;
+    running = match.running;
+    rng = match.arena.rng;
+    bots = match.arena.bots;
+    signals = match.arena.signals;
+}
+
+void RobotsSnapshot::Apply(RobotsMatch &match) const
+{
+    Arena &A = match.arena;
+    for (size_t i = 0; i < A.bots.size() && i < bots.size(); ++i) {
+        int32_t f[BOT_FIELDS];
+        packBot(bots[i], f);
+        unpackBot(f, A.bots[i]);
+    }
+    A.signals = signals;
+    A.rng = rng;
+    A.RebuildOccupancy();
+    match.turn = turn;
+    match.running = running;
+}
+
+// ===== RobotsReplayWriter =====
+void RobotsReplayWriter::Begin(const RobotsMatch &match, int keyframeInterval)
+{
+    const ArenaConfig &c = match.arena.cfg;
+    _interval = keyframeInterval > 0 ? keyframeInterval : 1;
+    _firstTurn = match.turn;
+    _width = std::max(1, c.width);
+    _header.clear();
+    _records.clear();
+    _turnOffsets.clear();
+
+    for (char ch : REPLAY_MAGIC) _header.push_back((uint8_t)ch);
+    putU32(_header, REPLAY_VERSION);
+    putU32(_header, (uint32_t)_interval);
+    putU32(_header, (uint32_t)_firstTurn);
+    putU32(_header, 0);         // last turn, patched by Finish()
+    putU64(_header, 0);         // index offset, patched by Finish()
+    putU64(_header, match.seed);
+    const int config[9] = { c.width, c.height, c.maxTurns, c.startHp, c.attackRange, c.attackCooldown, c.scanRange, c.instructionBudget,
+                            c.simultaneous ? 1 : 0 };
+    for (int v : config) putU32(_header, (uint32_t)v);
+    putU32(_header, (uint32_t)match.bots.size());
+    for (auto &bot : match.bots) {
+        const std::string &name = bot ? bot->name : std::string();
+        size_t len = std::min(name.size(), (size_t)0xffff);
+        _header.push_back((uint8_t)len);
+        _header.push_back((uint8_t)(len >> 8));
+        _header.insert(_header.end(), name.begin(), name.begin() + len);
+    }
+
+    RobotsSnapshot s;
+    s.Capture(match);
+    writeRecord(s);
+}
+
+void RobotsReplayWriter::Record(const RobotsMatch &match)
+{
+    if (!Active()) return;
+    RobotsSnapshot s;
+    s.Capture(match);
+    writeRecord(s);
+}
+
+void RobotsReplayWriter::Truncate(const RobotsSnapshot &at)
+{
+    int keep = at.turn - _firstTurn + 1;
+    if (!Active() || keep <= 0 || keep >= (int)_turnOffsets.size()) return;
+    _records.resize(_turnOffsets[keep]);
+    _turnOffsets.resize(keep);
+    // the next delta is taken against the turn we kept
+    _prev = at;
+}
+
+void RobotsReplayWriter::writeRecord(const RobotsSnapshot &s)
+{
+    const int width = _width;
+    bool keyframe = (int)_turnOffsets.size() % _interval == 0;
+    _turnOffsets.push_back(_records.size());
+
+    std::vector<uint8_t> &out = _records;
+    bool rngChanged = keyframe || s.rng.state != _prev.rng.state || s.rng.inc != _prev.rng.inc;
+    putU8(out, keyframe ? RECORD_KEYFRAME : RECORD_DELTA);
+    putU8(out, (uint8_t)((s.running ? FLAG_RUNNING : 0) | (rngChanged ? FLAG_RNG : 0)));
+    if (rngChanged) {
+        putU64(out, s.rng.state);
+        putU64(out, s.rng.inc);
+    }
+
+    if (keyframe) {
+        putVarint(out, s.bots.size());
+        for (auto &b : s.bots) {
+            int32_t f[BOT_FIELDS];
+            packBot(b, f);
+            for (int k = 0; k < BOT_FIELDS; ++k) putSigned(out, f[k]);
+        }
+    } else {
+        // changed bots: index gap, field mask, zigzag differences
+        std::vector<uint8_t> body;
+        int changed = 0, last = -1;
+        for (size_t i = 0; i < s.bots.size(); ++i) {
+            int32_t now[BOT_FIELDS], before[BOT_FIELDS];
+            packBot(s.bots[i], now);
+            packBot(_prev.bots[i], before);
+            uint32_t mask = 0;
+            for (int k = 0; k < BOT_FIELDS; ++k) {
+                if (now[k] != before[k]) mask |= 1u << k;
+            }
+            if (!mask) continue;
+            putVarint(body, (uint64_t)((int)i - last - 1));
+            putVarint(body, mask);
+            for (int k = 0; k < BOT_FIELDS; ++k) {
+                if (mask & (1u << k)) putSigned(body, (int64_t)now[k] - before[k]);
+            }
+            last = (int)i;
+            changed++;
+        }
+        putVarint(out, (uint64_t)changed);
+        out.insert(out.end(), body.begin(), body.end());
+    }
+
+    putVarint(out, s.signals.size());
+    int64_t prevCell = 0;
+    for (auto &p : s.signals) {
+        int64_t cell = (int64_t)p.second * width + p.first;
+        putSigned(out, cell - prevCell);
+        prevCell = cell;
+    }
+    _prev = s;
+}
+
+std::vector<uint8_t> RobotsReplayWriter::Finish() const
+{
+    std::vector<uint8_t> file = _header;
+    if (!Active()) return file;
+    patchU32(file, LAST_TURN_AT, (uint32_t)LastTurn());
+    patchU64(file, INDEX_AT, (uint64_t)(_header.size() + _records.size()));
+    file.insert(file.end(), _records.begin(), _records.end());
+
+    std::vector<uint8_t> index;
+    uint32_t keyframes = 0;
+    for (size_t i = 0; i < _turnOffsets.size(); i += _interval) {
+        putU64(index, (uint64_t)(_header.size() + _turnOffsets[i]));
+        keyframes++;
+    }
+    putU32(file, keyframes);
+    file.insert(file.end(), index.begin(), index.end());
+    return file;
+}
+
+bool RobotsReplayWriter::Save(const std::string &path) const
+{
+    std::vector<uint8_t> file = Finish();
+    FILE *f = fopen(path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = fwrite(file.data(), 1, file.size(), f) == file.size();
+    return fclose(f) == 0 && ok;
+}
+
+// ===== RobotsReplay =====
+bool RobotsReplay::Load(const std::string &path, std::string *error)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return Parse(std::move(data), error);
+}
+
+bool RobotsReplay::Parse(std::vector<uint8_t> data, std::string *error)
+{
+    auto fail = [&](const char *why) {
+        if (error) *error = why;
+        _data.clear();
+        _keyframes.clear();
+        _lastTurn = -1;
+        return false;
+    };
+    _data = std::move(data);
+    if (_data.size() < 4 || memcmp(_data.data(), REPLAY_MAGIC, 4) != 0) return fail("not a Robots replay");
+
+    ReplayReader r(_data, 4);
+    uint32_t version = r.u32();
+    if (version < 1 || version > REPLAY_VERSION) return fail("unsupported replay version");
+    _interval = (int)r.u32();
+    _firstTurn = (int)r.u32();
+    _lastTurn = (int)r.u32();
+    uint64_t indexAt = r.u64();
+    _seed = r.u64();
+    int config[9] = {};
+    for (int i = 0; i < (version >= 2 ? 9 : 8); ++i) config[i] = (int)r.u32();
+    _config = ArenaConfig();
+    _config.width = config[0]; _config.height = config[1]; _config.maxTurns = config[2]; _config.startHp = config[3];
+    _config.attackRange = config[4]; _config.attackCooldown = config[5]; _config.scanRange = config[6];
+    _config.instructionBudget = config[7];
+    _config.simultaneous = config[8] != 0;
+    uint32_t bots = r.u32();
+    _config.botCount = (int)bots;
+    _names.clear();
+    for (uint32_t i = 0; i < bots && r.ok; ++i) {
+        size_t len = r.u8();
+        len |= (size_t)r.u8() << 8;
+        if (!r.need(len)) break;
+        _names.emplace_back((const char *)_data.data() + r.pos, len);
+        r.pos += len;
+    }
+    if (!r.ok || _interval <= 0 || _config.width <= 0 || _config.height <= 0 || _lastTurn < _firstTurn) return fail("corrupt replay header");
+
+    ReplayReader idx(_data, (size_t)indexAt);
+    uint32_t count = idx.u32();
+    _keyframes.clear();
+    for (uint32_t i = 0; i < count && idx.ok; ++i) {
+        _keyframes.push_back(idx.u64());
+        if (_keyframes.back() >= _data.size()) idx.ok = false;
+    }
+    size_t expected = (size_t)(_lastTurn - _firstTurn) / _interval + 1;
+    if (!idx.ok || _keyframes.size() != expected) return fail("corrupt replay index");
+    return true;
+}
+
+// what Apply() may hand to the arena: every bot on the board, facing and
+// scan direction usable as dx/dy indices
+static bool validBots(const RobotsSnapshot &s, const ArenaConfig &c)
+{
+    for (const Arena::BotState &b : s.bots) {
+        if (b.x < 0 || b.y < 0 || b.x >= c.width || b.y >= c.height) return false;
+        if (b.dir < 0 || b.dir >= 8 || b.scan_dir < -1 || b.scan_dir >= 8) return false;
+    }
+    return true;
+}
+
+bool RobotsReplay::Seek(int turn, RobotsSnapshot &out) const
+{
+    if (turn < _firstTurn || turn > _lastTurn) return false;
+    int i = turn - _firstTurn;
+    ReplayReader r(_data, (size_t)_keyframes[i / _interval]);
+    int base = _firstTurn + (i / _interval) * _interval;
+
+    for (int t = base; t <= turn; ++t) {
+        uint8_t kind = r.u8();
+        uint8_t flags = r.u8();
+        if (kind != (t == base ? RECORD_KEYFRAME : RECORD_DELTA)) return false;
+        out.turn = t;
+        out.running = (flags & FLAG_RUNNING) != 0;
+        if (flags & FLAG_RNG) {
+            out.rng.state = r.u64();
+            out.rng.inc = r.u64();
+        }
+        if (kind == RECORD_KEYFRAME) {
+            uint64_t n = r.varint();
+            if (n != _names.size()) return false;
+            out.bots.assign(n, Arena::BotState());
+            for (auto &b : out.bots) {
+                int32_t f[BOT_FIELDS];
+                for (int k = 0; k < BOT_FIELDS; ++k) f[k] = (int32_t)r.sig();
+                unpackBot(f, b);
+            }
+        } else {
+            uint64_t changed = r.varint();
+            int at = -1;
+            for (uint64_t c = 0; c < changed && r.ok; ++c) {
+                at += (int)r.varint() + 1;
+                uint64_t mask = r.varint();
+                if (at < 0 || at >= (int)out.bots.size()) return false;
+                int32_t f[BOT_FIELDS];
+                packBot(out.bots[at], f);
+                for (int k = 0; k < BOT_FIELDS; ++k) {
+                    if (mask & (1u << k)) f[k] = (int32_t)(f[k] + r.sig());
+                }
+                unpackBot(f, out.bots[at]);
+            }
+        }
+        uint64_t signals = r.varint();
+        if (!r.ok || signals > _data.size()) return false;
+        out.signals.clear();
+        const int64_t cells = (int64_t)_config.width * _config.height;
+        int64_t cell = 0;
+        for (uint64_t s = 0; s < signals; ++s) {
+            int64_t step = r.sig();
+            if (!r.ok || step <= -cells || step >= cells) return false;
+            cell += step;
+            if (cell < 0 || cell >= cells) return false;
+            out.signals.emplace_back((int)(cell % _config.width), (int)(cell / _config.width));
+        }
+        if (!r.ok) return false;
+    }
+    return validBots(out, _config);
+}
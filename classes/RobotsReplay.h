@@ -0,0 +1,99 @@
+#pragma once
+
+#include "RobotsMatch.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ===== Robots replays =====
+// Binary match recording: a full keyframe every K turns and a compact delta
+// for each turn in between, plus an index of keyframe offsets at the end of
+// the file, so any turn is reached by decoding one keyframe and at most K-1
+// deltas.
+//
+// A snapshot holds everything that affects play: per-bot position, facing,
+// hp, damage flag, cooldown, scan result and signal, the signals emitted
+// this turn and the arena RNG. Applying one to a match set up with the same
+// roster and config resumes it exactly. VM cycle statistics are diagnostics
+// and not recorded.
+//
+// File layout (all integers little-endian):
+//   "RBRP" u32 version, u32 keyframe interval, i32 first turn, i32 last turn,
+//   u64 index offset, u64 seed, 9 x i32 ArenaConfig (8 in version 1, which
+//   predates simultaneous turns), u32 bots, bot names
+//   (u16 length + bytes), then one record per turn, then the index
+//   (u32 count + u64 offset per keyframe).
+// Records: u8 kind (keyframe / delta), u8 flags, then varints; deltas list
+// only the bots and fields that changed, as zigzag differences.
+
+struct RobotsSnapshot {
+    int turn = 0;
+    bool running = false;
+    RobotsRng rng;
+    std::vector<Arena::BotState> bots;          // gameplay fields only
+    std::vector<std::pair<int,int>> signals;
+
+    void Capture(const RobotsMatch &match);
+    // restore into a match set up with the same roster and config
+    void Apply(RobotsMatch &match) const;
+};
+
+class RobotsReplayWriter
+{
+public:
+    // header and a keyframe for the match as it stands (normally turn 0)
+    void Begin(const RobotsMatch &match, int keyframeInterval = 16);
+    // append the state after a Step()
+    void Record(const RobotsMatch &match);
+    // forget every turn after `at.turn`; `at` must be the state recorded for
+    // that turn (e.g. from RobotsReplay::Seek), and recording continues from it
+    void Truncate(const RobotsSnapshot &at);
+
+    bool Active() const { return !_header.empty(); }
+    int FirstTurn() const { return _firstTurn; }
+    int LastTurn() const { return _firstTurn + (int)_turnOffsets.size() - 1; }
+
+    // the complete file image
+    std::vector<uint8_t> Finish() const;
+    bool Save(const std::string &path) const;
+
+private:
+    void writeRecord(const RobotsSnapshot &s);
+
+    std::vector<uint8_t> _header;
+    std::vector<uint8_t> _records;
+    std::vector<size_t> _turnOffsets;   // offset of each turn's record in _records
+    RobotsSnapshot _prev;
+    int _interval = 16;
+    int _firstTurn = 0;
+    int _width = 1;             // signal cells are y * width + x
+};
+
+class RobotsReplay
+{
+public:
+    bool Load(const std::string &path, std::string *error = nullptr);
+    bool Parse(std::vector<uint8_t> data, std::string *error = nullptr);
+
+    const ArenaConfig &Config() const { return _config; }
+    uint64_t Seed() const { return _seed; }
+    const std::vector<std::string> &Names() const { return _names; }
+    int KeyframeInterval() const { return _interval; }
+    int FirstTurn() const { return _firstTurn; }
+    int LastTurn() const { return _lastTurn; }
+    size_t Bytes() const { return _data.size(); }
+
+    // decode the state after `turn`: one keyframe plus up to K-1 deltas;
+    // false if the record is corrupt or puts a bot or signal off the board
+    bool Seek(int turn, RobotsSnapshot &out) const;
+
+private:
+    std::vector<uint8_t> _data;
+    std::vector<uint64_t> _keyframes;
+    ArenaConfig _config;
+    uint64_t _seed = 0;
+    std::vector<std::string> _names;
+    int _interval = 16;
+    int _firstTurn = 0;
+    int _lastTurn = -1;
+};
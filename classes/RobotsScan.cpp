@@ -0,0 +1,239 @@
+#include "RobotsScan.h"
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ROBOTS_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// GCC/Clang build the vector kernels with per-function target attributes and
+// pick one at runtime; MSVC only gets the ones the compile flags allow
+#if defined(ROBOTS_SCAN_X86) && (defined(__GNUC__) || defined(__clang__))
+#define ROBOTS_TARGET(t) __attribute__((target(t)))
+#define ROBOTS_HAVE_AVX2 1
+#define ROBOTS_HAVE_SSE41 1
+#elif defined(ROBOTS_SCAN_X86)
+#define ROBOTS_TARGET(t)
+#if defined(__AVX2__)
+#define ROBOTS_HAVE_AVX2 1
+#endif
+#if defined(__AVX__) || defined(__SSE4_1__)
+#define ROBOTS_HAVE_SSE41 1
+#endif
+#endif
+
+int ScanDirection(int dx, int dy)
+{
+    // [sy+1][sx+1] -> Direction
+    static const int table[3][3] = {
+        { 7, 0, 4 },    // NW N NE
+        { 3,-1, 1 },    // W  .  E
+        { 6, 2, 5 },    // SW S SE
+    };
+    int sx = (dx > 0) - (dx < 0);
+    int sy = (dy > 0) - (dy < 0);
+    return table[sy + 1][sx + 1];
+}
+
+ScanHit ScanNearestScalar(const int* xs, const int* ys, int n, int x, int y, int range)
+{
+    ScanHit hit;
+    for (int i = 0; i < n; ++i) {
+        int dist = std::max(std::abs(xs[i] - x), std::abs(ys[i] - y));
+        if (dist == 0 || dist > range) continue;
+        if (hit.dist == 0 || dist < hit.dist) {
+            hit.dist = dist;
+            hit.index = i;
+        }
+    }
+    return hit;
+}
+
+// first index at exactly `dist`, starting the search at `from`
+static int firstAtDistance(const int* xs, const int* ys, int from, int n, int x, int y, int dist)
+{
+    for (int i = from; i < n; ++i) {
+        if (std::max(std::abs(xs[i] - x), std::abs(ys[i] - y)) == dist) return i;
+    }
+    return -1;
+}
+
+#if defined(ROBOTS_HAVE_AVX2)
+ROBOTS_TARGET("avx2")
+static ScanHit scanNearestAvx2(const int* xs, const int* ys, int n, int x, int y, int range)
+{
+    const __m256i vx = _mm256_set1_epi32(x);
+    const __m256i vy = _mm256_set1_epi32(y);
+    const __m256i vr = _mm256_set1_epi32(range);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i none = _mm256_set1_epi32(INT_MAX);
+    __m256i best = none;
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i ax = _mm256_loadu_si256((const __m256i*)(xs + i));
+        __m256i ay = _mm256_loadu_si256((const __m256i*)(ys + i));
+        __m256i d = _mm256_max_epi32(_mm256_abs_epi32(_mm256_sub_epi32(ax, vx)),
+                                     _mm256_abs_epi32(_mm256_sub_epi32(ay, vy)));
+        // valid = d > 0 && !(d > range)
+        __m256i valid = _mm256_andnot_si256(_mm256_cmpgt_epi32(d, vr), _mm256_cmpgt_epi32(d, zero));
+        best = _mm256_min_epi32(best, _mm256_blendv_epi8(none, d, valid));
+    }
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    int bestDist = _mm_cvtsi128_si32(m);
+
+    ScanHit tail = ScanNearestScalar(xs + i, ys + i, n - i, x, y, range);
+    if (tail.dist != 0 && tail.dist < bestDist) {
+        bestDist = tail.dist;
+    }
+    ScanHit hit;
+    if (bestDist == INT_MAX) return hit;
+
+    // second pass: lowest index at the winning distance
+    const __m256i target = _mm256_set1_epi32(bestDist);
+    int j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i ax = _mm256_loadu_si256((const __m256i*)(xs + j));
+        __m256i ay = _mm256_loadu_si256((const __m256i*)(ys + j));
+        __m256i d = _mm256_max_epi32(_mm256_abs_epi32(_mm256_sub_epi32(ax, vx)),
+                                     _mm256_abs_epi32(_mm256_sub_epi32(ay, vy)));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(d, target)));
+        if (mask) {
+            hit.dist = bestDist;
+            for (int k = 0; k < 8; ++k) {
+                if (mask & (1 << k)) { hit.index = j + k; break; }
+            }
+            return hit;
+        }
+    }
+    hit.dist = bestDist;
+    hit.index = firstAtDistance(xs, ys, j, n, x, y, bestDist);
+    return hit;
+}
+#endif
+
+#if defined(ROBOTS_HAVE_SSE41)
+ROBOTS_TARGET("sse4.1")
+static ScanHit scanNearestSse41(const int* xs, const int* ys, int n, int x, int y, int range)
+{
+    const __m128i vx = _mm_set1_epi32(x);
+    const __m128i vy = _mm_set1_epi32(y);
+    const __m128i vr = _mm_set1_epi32(range);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i none = _mm_set1_epi32(INT_MAX);
+    __m128i best = none;
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i ax = _mm_loadu_si128((const __m128i*)(xs + i));
+        __m128i ay = _mm_loadu_si128((const __m128i*)(ys + i));
+        __m128i d = _mm_max_epi32(_mm_abs_epi32(_mm_sub_epi32(ax, vx)),
+                                  _mm_abs_epi32(_mm_sub_epi32(ay, vy)));
+        __m128i valid = _mm_andnot_si128(_mm_cmpgt_epi32(d, vr), _mm_cmpgt_epi32(d, zero));
+        best = _mm_min_epi32(best, _mm_blendv_epi8(none, d, valid));
+    }
+    best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1)));
+    int bestDist = _mm_cvtsi128_si32(best);
+
+    ScanHit tail = ScanNearestScalar(xs + i, ys + i, n - i, x, y, range);
+    if (tail.dist != 0 && tail.dist < bestDist) {
+        bestDist = tail.dist;
+    }
+    ScanHit hit;
+    if (bestDist == INT_MAX) return hit;
+
+    const __m128i target = _mm_set1_epi32(bestDist);
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128i ax = _mm_loadu_si128((const __m128i*)(xs + j));
+        __m128i ay = _mm_loadu_si128((const __m128i*)(ys + j));
+        __m128i d = _mm_max_epi32(_mm_abs_epi32(_mm_sub_epi32(ax, vx)),
+                                  _mm_abs_epi32(_mm_sub_epi32(ay, vy)));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(d, target)));
+        if (mask) {
+            hit.dist = bestDist;
+            for (int k = 0; k < 4; ++k) {
+                if (mask & (1 << k)) { hit.index = j + k; break; }
+            }
+            return hit;
+        }
+    }
+    hit.dist = bestDist;
+    hit.index = firstAtDistance(xs, ys, j, n, x, y, bestDist);
+    return hit;
+}
+#endif
+
+typedef ScanHit (*ScanKernel)(const int*, const int*, int, int, int, int);
+
+struct ScanDispatch {
+    ScanKernel kernel = ScanNearestScalar;
+    const char* name = "scalar";
+    ScanDispatch()
+    {
+#if defined(ROBOTS_HAVE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        if (__builtin_cpu_supports("avx2")) { kernel = scanNearestAvx2; name = "avx2"; return; }
+#elif defined(ROBOTS_HAVE_AVX2)
+        kernel = scanNearestAvx2; name = "avx2"; return;
+#endif
+#if defined(ROBOTS_HAVE_SSE41) && (defined(__GNUC__) || defined(__clang__))
+        if (__builtin_cpu_supports("sse4.1")) { kernel = scanNearestSse41; name = "sse4.1"; return; }
+#elif defined(ROBOTS_HAVE_SSE41)
+        kernel = scanNearestSse41; name = "sse4.1"; return;
+#endif
+    }
+};
+
+static const ScanDispatch& scanDispatch()
+{
+    static const ScanDispatch dispatch;
+    return dispatch;
+}
+
+ScanHit ScanNearestSimd(const int* xs, const int* ys, int n, int x, int y, int range)
+{
+    return scanDispatch().kernel(xs, ys, n, x, y, range);
+}
+
+const char* ScanKernelName()
+{
+    return scanDispatch().name;
+}
+
+ScanHit ScanNearestGrid(const int* occupancy, int width, int height, int x, int y, int range)
+{
+    ScanHit hit;
+    int maxRing = std::min(range, std::max(std::max(x, width - 1 - x), std::max(y, height - 1 - y)));
+    for (int d = 1; d <= maxRing; ++d) {
+        int best = INT_MAX;
+        int x0 = x - d, x1 = x + d, y0 = y - d, y1 = y + d;
+        int cx0 = std::max(x0, 0), cx1 = std::min(x1, width - 1);
+        // top and bottom rows of the ring
+        if (y0 >= 0) {
+            const int* row = occupancy + (size_t)y0 * width;
+            for (int cx = cx0; cx <= cx1; ++cx) if (row[cx] >= 0 && row[cx] < best) best = row[cx];
+        }
+        if (y1 < height) {
+            const int* row = occupancy + (size_t)y1 * width;
+            for (int cx = cx0; cx <= cx1; ++cx) if (row[cx] >= 0 && row[cx] < best) best = row[cx];
+        }
+        // left and right columns, corners already done
+        int cy0 = std::max(y0 + 1, 0), cy1 = std::min(y1 - 1, height - 1);
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            const int* row = occupancy + (size_t)cy * width;
+            if (x0 >= 0 && row[x0] >= 0 && row[x0] < best) best = row[x0];
+            if (x1 < width && row[x1] >= 0 && row[x1] < best) best = row[x1];
+        }
+        if (best != INT_MAX) {
+            hit.dist = d;
+            hit.index = best;
+            return hit;
+        }
+    }
+    return hit;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// ===== Nearest-enemy scan kernels =====
+// Every kernel answers exactly what the original Arena::Scan loop did: the
+// lowest-index bot at the smallest Chebyshev distance d with 0 < d <= range.
+// Positions come in as SoA int arrays; dead bots are parked at SCAN_FAR so
+// they never qualify and the kernels need no alive mask.
+
+static constexpr int SCAN_FAR = 1 << 29;
+
+struct ScanHit {
+    int dist = 0;       // 0 means nothing seen
+    int index = -1;
+};
+
+// plain loop, the reference every other kernel must match
+ScanHit ScanNearestScalar(const int* xs, const int* ys, int n, int x, int y, int range);
+// AVX2 / SSE4.1 when the CPU has them (picked once at runtime), else scalar
+ScanHit ScanNearestSimd(const int* xs, const int* ys, int n, int x, int y, int range);
+// ring walk over the occupancy grid; cheaper than a linear pass once the
+// scan window holds fewer cells than there are bots
+ScanHit ScanNearestGrid(const int* occupancy, int width, int height, int x, int y, int range);
+
+// name of the vector kernel ScanNearestSimd dispatches to
+const char* ScanKernelName();
+
+// 8-way compass quantization of a delta (Direction value, -1 for 0,0)
+int ScanDirection(int dx, int dy);
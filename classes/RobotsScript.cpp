@@ -0,0 +1,391 @@
+#include "RobotsScript.h"
+#include "RobotsBundle.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+
+// bump when the compiler's output changes, so cached bundles are rebuilt
+static const char SCRIPT_FORMAT[] = "robots-bot 1\n";
+
+// ===== Statements =====
+struct ScriptStatement {
+    const char *name;
+    int op;
+    bool operand;
+};
+
+static const ScriptStatement STATEMENTS[] = {
+    {"WAIT_", OP_WAIT, false},          {"MOVE", OP_MOVE, true},
+    {"TURN", OP_TURN, true},            {"ATTACK", OP_ATTACK, true},
+    {"SIGNAL", OP_SIGNAL, true},        {"ATTACK_SCAN", OP_ATTACK_SCAN, false},
+    {"SCAN", OP_SCAN, false},           {"TURN_SCAN", OP_TURN_SCAN, false},
+    {"TURN_AWAY", OP_TURN_AWAY, false}, {"TURN_RANDOM", OP_TURN_RANDOM, false},
+    {"IF_ENEMY", OP_IF_ENEMY, true},    {"IF_TURN_LT", OP_IF_TURN_LESS, true},
+    {"IF_SEEN", OP_IF_SEEN, false},     {"IF_SCAN_LE", OP_IF_SCAN_LE, true},
+    {"IF_NEAR_SIGNAL", OP_IF_NEAR_SIGNAL, true},
+    {"IF_DAMAGED", OP_IF_DAMAGED, false},
+    {"IF_HP_LE", OP_IF_HP_LE, true},    {"IF_CAN_ATTACK", OP_IF_CAN_ATTACK, false},
+    {"IF_NEAR_EDGE", OP_IF_NEAR_EDGE, true},
+    {"MOVE_TOWARD", OP_MOVE_TOWARD, true},
+};
+
+static const char *const DIRECTIONS[8] = {"NORTH", "EAST", "SOUTH", "WEST", "NORTHEAST", "SOUTHEAST", "SOUTHWEST", "NORTHWEST"};
+static const char *const TARGETS[FLOW_TARGET_COUNT] = {"TOWARD_ENEMY", "TOWARD_SIGNAL", "TOWARD_CENTER"};
+
+static bool isCondition(int op) { return op >= OP_IF_ENEMY && op <= OP_IF_NEAR_EDGE; }
+
+// ===== Parser =====
+namespace {
+    class ScriptParser
+    {
+    public:
+        explicit ScriptParser(const std::string &source) : _p(source.c_str()) {}
+
+        bool Parse(BotScript &script)
+        {
+            if (!block(script.body, 0, &script.name)) return false;
+            if (*_p) return fail("unexpected '" + std::string(1, *_p) + "'");
+            return true;
+        }
+        const std::string &Error() const { return _error; }
+
+    private:
+        bool fail(const std::string &why)
+        {
+            _error = "line " + std::to_string(_line) + ": " + why;
+            return false;
+        }
+
+        void skip()
+        {
+            for (;;) {
+                if (*_p == '\n') { _line++; _p++; }
+                else if (isspace((unsigned char)*_p)) _p++;
+                else if (_p[0] == '/' && _p[1] == '/') { while (*_p && *_p != '\n') _p++; }
+                else if (_p[0] == '/' && _p[1] == '*') {
+                    _p += 2;
+                    while (*_p && !(_p[0] == '*' && _p[1] == '/')) { if (*_p == '\n') _line++; _p++; }
+                    if (*_p) _p += 2;
+                }
+                else return;
+            }
+        }
+
+        bool accept(char c)
+        {
+            skip();
+            if (*_p != c) return false;
+            _p++;
+            return true;
+        }
+
+        std::string word()
+        {
+            skip();
+            const char *start = _p;
+            while (isalnum((unsigned char)*_p) || *_p == '_') _p++;
+            return std::string(start, _p);
+        }
+
+        bool operand(int &value)
+        {
+            skip();
+            if (isalpha((unsigned char)*_p)) {
+                std::string w = word();
+                for (int d = 0; d < 8; ++d) {
+                    if (w == DIRECTIONS[d]) { value = d; return true; }
+                }
+                for (int t = 0; t < FLOW_TARGET_COUNT; ++t) {
+                    if (w == TARGETS[t]) { value = t; return true; }
+                }
+                return fail("expected a number, a direction or a target, got " + w);
+            }
+            char *end = nullptr;
+            long v = strtol(_p, &end, 10);
+            if (end == _p) return fail("expected a number or a direction");
+            _p = end;
+            value = (int)v;
+            return true;
+        }
+
+        // statements up to '}' or the end of the script; `name` is only
+        // passed at the top level, where NAME() and return Finalize() live
+        bool block(RobotGenome &out, int depth, std::string *name)
+        {
+            bool ifBefore = false;      // ELSE() may follow an IF block
+            for (;;) {
+                skip();
+                if (*_p == 0 || *_p == '}') return true;
+                if (*_p == ';') { _p++; continue; }
+                int line = _line;
+                std::string w = word();
+                if (w.empty()) return fail("unexpected '" + std::string(1, *_p) + "'");
+
+                if (w == "return" && name) {
+                    if (word() != "Finalize" || !accept('(') || !accept(')')) return fail("expected return Finalize()");
+                    accept(';');
+                    skip();
+                    if (*_p) return fail("statements after return Finalize()");
+                    return true;
+                }
+                if (w == "NAME" && name) {
+                    if (!name->empty()) return fail("NAME() given twice");
+                    if (!accept('(')) return fail("expected '(' after NAME");
+                    skip();
+                    const char *start = _p;
+                    while (*_p && *_p != ')' && *_p != '\n') _p++;
+                    std::string n(start, _p);
+                    while (!n.empty() && isspace((unsigned char)n.back())) n.pop_back();
+                    if (n.size() >= 2 && n.front() == '"' && n.back() == '"') n = n.substr(1, n.size() - 2);
+                    if (n.empty() || !accept(')')) return fail("expected NAME(name)");
+                    *name = n;
+                    ifBefore = false;
+                    continue;
+                }
+                if (w == "ELSE") {
+                    if (!ifBefore) return fail("ELSE() without IF");
+                    if (!accept('(') || !accept(')') || !accept('{')) return fail("expected ELSE() {");
+                    // checked, but dropped: the IF macro never reaches its else
+                    RobotGenome unused;
+                    if (depth >= 64) return fail("IF blocks nested too deep");
+                    if (!block(unused, depth + 1, nullptr)) return false;
+                    if (!accept('}')) return fail("missing '}'");
+                    ifBefore = false;
+                    continue;
+                }
+
+                const ScriptStatement *st = nullptr;
+                for (const ScriptStatement &s : STATEMENTS) {
+                    if (w == s.name) st = &s;
+                }
+                if (!st) return fail("unknown statement " + w);
+                GeneNode n;
+                n.op = st->op;
+                if (!accept('(')) return fail("expected '(' after " + w);
+                if (st->operand && !operand(n.arg)) return false;
+                if (st->operand && !OperandInRange(n.op, n.arg)) return fail("operand " + std::to_string(n.arg) + " out of range for " + w);
+                if (!accept(')')) return fail(st->operand ? "expected ')' after the operand of " + w : w + " takes no operand");
+                if (isCondition(n.op)) {
+                    if (!accept('{')) return fail("expected '{' after " + w + "()");
+                    if (depth >= 64) return fail("IF blocks nested too deep");
+                    if (!block(n.body, depth + 1, nullptr)) return false;
+                    if (!accept('}')) {
+                        _line = line;
+                        return fail("unclosed " + w + " block");
+                    }
+                }
+                ifBefore = isCondition(n.op);
+                out.push_back(std::move(n));
+            }
+        }
+
+        const char *_p;
+        int _line = 1;
+        std::string _error;
+    };
+}
+
+bool ParseBotScript(const std::string &source, BotScript &script, std::string *error)
+{
+    script = BotScript();
+    ScriptParser parser(source);
+    if (!parser.Parse(script)) {
+        if (error) *error = parser.Error();
+        return false;
+    }
+    int cost = GenomeCost(script.body);
+    if (cost > MAX_SCRIPT_COST) {
+        if (error) *error = "script cost " + std::to_string(cost) + " exceeds " + std::to_string(MAX_SCRIPT_COST);
+        return false;
+    }
+    return true;
+}
+
+std::string BotScriptSource(const RobotGenome &body, const std::string &name)
+{
+    return "NAME(" + name + ")\n" + GenomeBody(body, 0);
+}
+
+// ===== RobotsScriptLoader =====
+static bool readFile(const std::string &path, std::string &text)
+{
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    text.clear();
+    char buffer[4096];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), f)) > 0) text.append(buffer, got);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t n)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < n; ++i) { hash ^= p[i]; hash *= 0x100000001b3ULL; }
+    return hash;
+}
+
+static RobotEntry bundleEntry(const std::string &name, std::shared_ptr<const RobotProgram> program)
+{
+    return RobotEntry{ name, [name, program]{ return std::unique_ptr<RobotBase>(std::make_unique<BundleBot>(name, program)); } };
+}
+
+// a record carried over from the cache bundle when it is rewritten
+struct StoredBot : RobotBase {
+    StoredBot(std::vector<int> storedCode, int cost) : _code(std::move(storedCode)), _cost(cost) {}
+    int SetupRobot() override {
+        code = _code;
+        script_cost = _cost;
+        return script_cost;
+    }
+private:
+    std::vector<int> _code;
+    int _cost;
+};
+
+static RobotEntry storedEntry(const RobotsBundle &bundle, int i)
+{
+    auto code = std::make_shared<const std::vector<int>>(bundle.Code(i));
+    int cost = bundle.ScriptCost(i);
+    return RobotEntry{ bundle.Name(i), [code, cost]{ return std::unique_ptr<RobotBase>(std::make_unique<StoredBot>(*code, cost)); } };
+}
+
+// written aside and renamed, so a reader never maps half a file; a cache
+// that cannot be written only costs the next run a parse
+static void writeCache(const std::string &dir, const std::string &path, const std::vector<RobotEntry> &records)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    std::string partial = path + ".tmp";
+    if (WriteBotBundle(partial, records)) {
+        std::filesystem::rename(partial, path, ec);
+        if (ec) std::filesystem::remove(partial, ec);
+    }
+}
+
+bool RobotsScriptLoader::Load(const std::string &path, RobotEntry &entry, std::string *error)
+{
+    std::vector<RobotEntry> roster;
+    if (!loadFiles({path}, roster, error)) return false;
+    entry = std::move(roster.front());
+    return true;
+}
+
+bool RobotsScriptLoader::LoadDirectory(const std::string &dir, std::vector<RobotEntry> &roster, std::string *error)
+{
+    std::error_code ec;
+    std::vector<std::string> paths;
+    for (const auto &file : std::filesystem::directory_iterator(dir, ec)) {
+        if (file.is_regular_file() && file.path().extension() == ".bot") paths.push_back(file.path().string());
+    }
+    if (ec) {
+        if (error) *error = "cannot list " + dir;
+        return false;
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths.empty() || loadFiles(paths, roster, error);
+}
+
+// cache records are named by the script's key in hex, then its NAME()
+static constexpr size_t KEY_DIGITS = 16;
+
+std::string RobotsScriptLoader::cachePath() const
+{
+    return (std::filesystem::path(_cacheDir) / "scripts.rbb").string();
+}
+
+bool RobotsScriptLoader::loadFiles(const std::vector<std::string> &paths, std::vector<RobotEntry> &roster, std::string *error)
+{
+    size_t first = roster.size();
+    auto fail = [&](const std::string &why) {
+        roster.resize(first);
+        if (error) *error = why;
+        return false;
+    };
+    RobotsBundle cache;
+    std::map<std::string, int> records;     // key -> record in `cache`
+    if (!_cacheDir.empty() && cache.Open(cachePath())) {
+        for (int i = 0; i < cache.Size(); ++i) {
+            if (cache.Name(i).size() >= KEY_DIGITS) records[cache.Name(i).substr(0, KEY_DIGITS)] = i;
+        }
+    }
+
+    std::vector<RobotEntry> compiled;       // new records for the cache
+    std::string source;
+    for (const std::string &path : paths) {
+        if (!readFile(path, source)) return fail(path + ": cannot read");
+        auto nameOf = [&](const std::string &declared) {
+            return declared.empty() ? std::filesystem::path(path).stem().string() : declared;
+        };
+        // key: FNV-1a over the format tag and this script's text alone, so
+        // editing one script leaves every other record valid
+        uint64_t key = fnv1a(0xcbf29ce484222325ULL, SCRIPT_FORMAT, strlen(SCRIPT_FORMAT));
+        uint64_t length = source.size();
+        key = fnv1a(key, &length, sizeof(length));
+        key = fnv1a(key, source.data(), source.size());
+        char hex[KEY_DIGITS + 1];
+        snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)key);
+        _used.insert(hex);
+
+        auto hit = records.find(hex);
+        if (hit != records.end()) {
+            roster.push_back(bundleEntry(nameOf(cache.Name(hit->second).substr(KEY_DIGITS)), cache.Program(hit->second)));
+            _cacheHits++;
+            continue;
+        }
+        BotScript script;
+        std::string why;
+        if (!ParseBotScript(source, script, &why)) return fail(path + ": " + why);
+        auto body = std::make_shared<const RobotGenome>(std::move(script.body));
+        const std::string declared = script.name;
+        RobotEntry entry{ hex + declared, [body, declared]{ return std::unique_ptr<RobotBase>(std::make_unique<GenomeBot>(body, declared)); } };
+        std::unique_ptr<RobotBase> bot = entry.make();
+        bot->SetupRobot();
+        roster.push_back(bundleEntry(nameOf(declared), bot->program));
+        _parsed++;
+        if (!_cacheDir.empty() && records.emplace(hex, -1).second) compiled.push_back(std::move(entry));
+    }
+
+    // the old records stay until Prune(): the cache may serve other loads
+    if (!compiled.empty()) {
+        std::vector<RobotEntry> all;
+        for (int i = 0; i < cache.Size(); ++i) all.push_back(storedEntry(cache, i));
+        all.insert(all.end(), compiled.begin(), compiled.end());
+        cache.Close();
+        writeCache(_cacheDir, cachePath(), all);
+    }
+    return true;
+}
+
+int RobotsScriptLoader::Prune()
+{
+    if (_cacheDir.empty()) return 0;
+    int removed = 0;
+    std::error_code ec;
+    std::vector<std::filesystem::path> others;
+    for (const auto &file : std::filesystem::directory_iterator(_cacheDir, ec)) {
+        if (file.is_regular_file() && file.path().extension() == ".rbb" && file.path().filename() != "scripts.rbb") {
+            others.push_back(file.path());
+        }
+    }
+    for (const auto &path : others) removed += std::filesystem::remove(path, ec) ? 1 : 0;
+
+    RobotsBundle cache;
+    if (!cache.Open(cachePath())) return removed;
+    std::vector<RobotEntry> kept;
+    for (int i = 0; i < cache.Size(); ++i) {
+        if (cache.Name(i).size() >= KEY_DIGITS && _used.count(cache.Name(i).substr(0, KEY_DIGITS))) kept.push_back(storedEntry(cache, i));
+    }
+    if ((int)kept.size() == cache.Size()) return removed;
+    removed += cache.Size() - (int)kept.size();
+    cache.Close();
+    if (kept.empty()) std::filesystem::remove(cachePath(), ec);
+    else writeCache(_cacheDir, cachePath(), kept);
+    return removed;
+}
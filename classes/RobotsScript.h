@@ -0,0 +1,78 @@
+#pragma once
+
+#include "RobotsEvolve.h"
+#include <set>
+#include <string>
+#include <vector>
+
+// ===== .bot scripts =====
+// Bots as text, loaded at runtime instead of compiled into the program. A
+// script is a SetupRobot() body in the macro DSL:
+//
+//   NAME(Shy)
+//   SCAN();
+//   IF_SCAN_LE(5) {
+//       TURN_AWAY();
+//       MOVE(2);
+//       SIGNAL(2);
+//   } ELSE() {
+//       MOVE(1);
+//   }
+//
+// Statements are the macros with their operands (integers, NORTH ...
+// NORTHWEST for directions, or TOWARD_ENEMY, TOWARD_SIGNAL and TOWARD_CENTER
+// for MOVE_TOWARD's targets); the semicolons are optional, // and /* */
+// comments are skipped, and a trailing `return Finalize();` is accepted so a
+// body can be pasted from C++ as is. NAME() is optional and defaults to the
+// file name. An operand the arena cannot run (see OperandInRange) rejects
+// the script.
+//
+// The statement tree is emitted through GenomeBot, i.e. the macros
+// themselves, so code and script_cost are exactly what the same body
+// produces in a RobotBase subclass. That includes ELSE(): it is parsed and
+// checked, but the macros never emit its body, so neither does the loader.
+// Scripts over MAX_SCRIPT_COST are rejected.
+struct BotScript {
+    std::string name;       // from NAME(), empty if the script has none
+    RobotGenome body;
+};
+
+// errors are reported as "line N: ..."
+bool ParseBotScript(const std::string &source, BotScript &script, std::string *error = nullptr);
+
+// the script text for a statement tree
+std::string BotScriptSource(const RobotGenome &body, const std::string &name);
+
+// Loads scripts as roster entries. With a cache directory, every script
+// compiled is stored in one bot bundle there (see RobotsBundle.h), as a
+// record keyed by a hash of that script's own text; a later load maps the
+// bundle once and takes each unchanged script from it instead of parsing.
+// Editing one script recompiles only that one. Entries make BundleBots,
+// which share one lowered program per script.
+class RobotsScriptLoader
+{
+public:
+    explicit RobotsScriptLoader(std::string cacheDir = std::string()) : _cacheDir(std::move(cacheDir)) {}
+
+    // errors are prefixed with the path
+    bool Load(const std::string &path, RobotEntry &entry, std::string *error = nullptr);
+    // every *.bot file in `dir`, sorted by file name
+    bool LoadDirectory(const std::string &dir, std::vector<RobotEntry> &roster, std::string *error = nullptr);
+
+    int Parsed() const { return _parsed; }          // scripts compiled from text
+    int CacheHits() const { return _cacheHits; }    // scripts mapped from the cache
+    // drop the cache records no script loaded so far maps to (those of
+    // edited or deleted scripts) and any other bundle in the cache
+    // directory; returns how many. Only for a cache that belongs to the
+    // scripts this loader was given.
+    int Prune();
+
+private:
+    bool loadFiles(const std::vector<std::string> &paths, std::vector<RobotEntry> &roster, std::string *error);
+    std::string cachePath() const;
+
+    std::string _cacheDir;
+    std::set<std::string> _used;    // cache keys of the scripts loaded
+    int _parsed = 0;
+    int _cacheHits = 0;
+};
@@ -0,0 +1,109 @@
+#include "RobotsTournament.h"
+#include "RobotsAnalytics.h"
+#include "RobotsMatch.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+
+namespace {
+    // outcome of one match, written by exactly one task
+    struct MatchOutcome {
+        int winner = -1;   // seat index
+        int turns = 0;
+        std::vector<bool> alive;
+    };
+}
+
+std::vector<std::vector<int>> TournamentLineups(int rosterSize, const TournamentOptions &options)
+{
+    std::vector<std::vector<int>> lineups;
+    if (options.pairings) {
+        for (int a = 0; a < rosterSize; ++a) {
+            for (int b = a + 1; b < rosterSize; ++b) {
+                lineups.push_back({a, b});
+            }
+        }
+    }
+    if (options.freeForAll && rosterSize > 2) {
+        std::vector<int> all;
+        for (int i = 0; i < rosterSize; ++i) all.push_back(i);
+        lineups.push_back(all);
+    }
+    return lineups;
+}
+
+TournamentResult RunTournament(const std::vector<RobotEntry> &roster, const TournamentOptions &options)
+{
+    TournamentResult result;
+    result.seed = options.seed;
+    int n = (int)roster.size();
+    for (auto &entry : roster) result.names.push_back(entry.name);
+    result.pairings.assign(n, TournamentRecord());
+    result.freeForAll.assign(n, TournamentRecord());
+    result.headToHead.assign(n, std::vector<TournamentRecord>(n));
+
+    std::vector<std::vector<int>> lineups = TournamentLineups(n, options);
+    int rounds = std::max(options.rounds, 0);
+
+    // seat order rotates every round so no bot always moves first
+    std::vector<std::vector<int>> seatings;
+    for (auto &lineup : lineups) {
+        for (int r = 0; r < rounds; ++r) {
+            std::vector<int> seats(lineup.size());
+            for (size_t s = 0; s < lineup.size(); ++s) {
+                seats[s] = lineup[(s + r) % lineup.size()];
+            }
+            seatings.push_back(seats);
+        }
+    }
+
+    std::vector<MatchOutcome> outcomes(seatings.size());
+    auto start = std::chrono::steady_clock::now();
+    {
+        WorkStealingPool pool(options.threads);
+        result.threads = pool.Size();
+        for (size_t m = 0; m < seatings.size(); ++m) {
+            pool.Submit([&, m] {
+                std::vector<std::unique_ptr<RobotBase>> bots;
+                for (int idx : seatings[m]) {
+                    bots.emplace_back(roster[idx].make());
+                }
+                RobotsMatch match;
+                RobotsMatchStats stats;
+                if (options.analytics) match.arena.stats = &stats;
+                match.Setup(std::move(bots), options.seed + m);
+                match.Play();
+                if (options.analytics) options.analytics->Append(match, stats);
+
+                MatchOutcome &out = outcomes[m];
+                out.winner = match.Winner();
+                out.turns = match.TurnsPlayed();
+                for (auto &b : match.arena.bots) out.alive.push_back(b.alive);
+            });
+        }
+        pool.Wait();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // tally on the calling thread once every match is in
+    for (size_t m = 0; m < seatings.size(); ++m) {
+        const std::vector<int> &seats = seatings[m];
+        const MatchOutcome &out = outcomes[m];
+        bool isPair = seats.size() == 2;
+        result.matches++;
+        result.turns += out.turns;
+
+        for (size_t s = 0; s < seats.size(); ++s) {
+            TournamentRecord rec;
+            rec.played = 1;
+            if (out.winner == (int)s) rec.wins = 1;
+            else if (out.winner == -1 && out.alive[s]) rec.draws = 1;
+            else rec.losses = 1;
+
+            (isPair ? result.pairings : result.freeForAll)[seats[s]].Add(rec);
+            if (isPair) {
+                result.headToHead[seats[s]][seats[1 - s]].Add(rec);
+            }
+        }
+    }
+    return result;
+}
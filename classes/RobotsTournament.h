@@ -0,0 +1,43 @@
+#pragma once
+
+#include "RobotsArena.h"
+
+class RobotsAnalyticsWriter;
+
+// ===== Round-robin tournament over a roster =====
+// Every pairing and the full free-for-all lineup are played `rounds` times
+// each. Matches run on a WorkStealingPool; each one builds its own Arena and
+// fresh RobotBase instances from the roster factories.
+struct TournamentOptions {
+    int rounds = 100;          // matches per lineup
+    unsigned threads = 0;      // 0 = one per core
+    bool pairings = true;      // every 1v1 pairing
+    bool freeForAll = true;    // all bots in one arena
+    uint64_t seed = 0;         // match m is played with seed + m
+    RobotsAnalyticsWriter *analytics = nullptr;     // per-bot stats of every match go here (not owned)
+};
+
+struct TournamentRecord {
+    int played = 0;
+    int wins = 0;
+    int draws = 0;             // survived the turn limit with others standing
+    int losses = 0;
+    void Add(const TournamentRecord &o) { played += o.played; wins += o.wins; draws += o.draws; losses += o.losses; }
+};
+
+struct TournamentResult {
+    std::vector<std::string> names;
+    std::vector<TournamentRecord> pairings;                  // per bot, 1v1 matches only
+    std::vector<TournamentRecord> freeForAll;                // per bot, free-for-all only
+    std::vector<std::vector<TournamentRecord>> headToHead;   // [a][b]: a's record against b
+    int matches = 0;
+    long long turns = 0;
+    double seconds = 0.0;
+    unsigned threads = 0;
+    uint64_t seed = 0;
+};
+
+// the lineups a tournament plays: each entry lists roster indices in seat order
+std::vector<std::vector<int>> TournamentLineups(int rosterSize, const TournamentOptions &options);
+
+TournamentResult RunTournament(const std::vector<RobotEntry> &roster, const TournamentOptions &options);
@@ -0,0 +1,431 @@
+#include "RobotsArena.h"
+#include <chrono>
+#include <climits>
+#include <cstdio>
+
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(ROBOTS_VM_SWITCH)
+#define ROBOTS_VM_THREADED 1
+#endif
+
+static_assert(OP_JF_ENEMY == OP_MOVE_TOWARD + 1, "superinstructions must follow the p-code opcodes");
+static_assert(OP_JF_NEAR_EDGE - OP_JF_ENEMY == OP_IF_NEAR_EDGE - OP_IF_ENEMY, "OP_JF_* must mirror OP_IF_*");
+
+// ops followed by one operand int in p-code (IF_SEEN/DAMAGED/CAN_ATTACK carry
+// an unused placeholder)
+static bool hasOperand(int op){
+    switch(op){
+        case OP_MOVE: case OP_TURN: case OP_ATTACK: case OP_SIGNAL:
+        case OP_IF_ENEMY: case OP_IF_TURN_LESS: case OP_IF_SEEN: case OP_IF_SCAN_LE: case OP_IF_NEAR_SIGNAL:
+        case OP_IF_DAMAGED: case OP_IF_HP_LE: case OP_IF_CAN_ATTACK: case OP_IF_NEAR_EDGE:
+        case OP_JUMP_IF_FALSE: case OP_JUMP: case OP_MOVE_TOWARD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool OperandInRange(int op, int arg){
+    switch(op){
+        case OP_TURN: case OP_ATTACK: case OP_IF_ENEMY:
+            return arg >= 0 && arg < 8;
+        case OP_MOVE:
+            return arg >= 1 && arg <= MAX_SCRIPT_COST / COST_MOVE;
+        case OP_MOVE_TOWARD:
+            return arg >= 0 && arg < FLOW_TARGET_COUNT;
+        case OP_SIGNAL: case OP_IF_TURN_LESS: case OP_IF_SCAN_LE: case OP_IF_NEAR_SIGNAL:
+        case OP_IF_HP_LE: case OP_IF_NEAR_EDGE:
+            return arg >= 0;
+        default:
+            return true;
+    }
+}
+
+// what the DSL macro for `op` adds to script_cost
+static int actionCost(int op, int arg){
+    switch(op){
+        case OP_MOVE: return COST_MOVE * arg;
+        case OP_TURN: case OP_TURN_SCAN: case OP_TURN_AWAY: case OP_TURN_RANDOM: return COST_TURN;
+        case OP_ATTACK: case OP_ATTACK_SCAN: return COST_ATTACK;
+        case OP_SIGNAL: return COST_SIGNAL;
+        case OP_SCAN: return COST_SCAN;
+        case OP_MOVE_TOWARD: return COST_MOVE_TOWARD;
+        default: return COST_WAIT;
+    }
+}
+
+bool CheckProgramCode(const int *code, int n, int scriptCost, std::string *error){
+    auto fail = [&](const std::string &why){
+        if(error) *error = why;
+        return false;
+    };
+    // walked as LowerProgram walks it; whatever follows a stop is never run
+    int cost = 0;
+    for(int pc = 0; pc < n; ){
+        int op = code[pc];
+        if(op < 0 || op >= OP_JF_ENEMY) break;
+        int len = hasOperand(op) ? 2 : 1;
+        if(pc + len > n) break;
+        int arg = len == 2 ? code[pc+1] : 0;
+        if(len == 2 && !OperandInRange(op, arg)){
+            return fail("operand " + std::to_string(arg) + " out of range for " + RobotVmOpName(op) + " at " + std::to_string(pc));
+        }
+        cost += actionCost(op, arg);
+        pc += len;
+    }
+    if(cost != scriptCost) return fail("script_cost " + std::to_string(scriptCost) + " does not match the code (" + std::to_string(cost) + ")");
+    if(cost > MAX_SCRIPT_COST) return fail("script cost " + std::to_string(cost) + " exceeds " + std::to_string(MAX_SCRIPT_COST));
+    return true;
+}
+
+static int edgeDistance(const Arena &A, const Arena::BotState &b){
+    int to_left   = b.x;
+    int to_right  = A.cfg.width - 1 - b.x;
+    int to_top    = b.y;
+    int to_bottom = A.cfg.height - 1 - b.y;
+    return std::min(std::min(to_left,to_right), std::min(to_top,to_bottom));
+}
+
+// Runs a lowered program for one bot turn. Called with ip == nullptr it only
+// hands back the handler table LowerProgram stores into each instruction.
+// PROFILE = true is the instrumented twin used for bots with a RobotProfile:
+// it dispatches through its own table by op (the stored handlers belong to
+// the plain instantiation) and counts as it goes.
+template <bool PROFILE>
+static const void* const* runProgram(RobotBase *bot, const RobotInstr *ip, int turn){
+#if ROBOTS_VM_THREADED
+    // in OpCode order
+    static const void* const labels[] = {
+        &&op_WAIT, &&op_MOVE, &&op_TURN, &&op_ATTACK, &&op_SIGNAL, &&op_ATTACK_SCAN, &&op_SCAN,
+        &&op_TURN_SCAN, &&op_TURN_AWAY, &&op_TURN_RANDOM,
+        &&op_IF_ENEMY, &&op_IF_TURN_LESS, &&op_IF_SEEN, &&op_IF_SCAN_LE, &&op_IF_NEAR_SIGNAL,
+        &&op_IF_DAMAGED, &&op_IF_HP_LE, &&op_IF_CAN_ATTACK, &&op_IF_NEAR_EDGE,
+        &&op_JUMP_IF_FALSE, &&op_JUMP, &&op_END, &&op_MOVE_TOWARD,
+        &&op_JF_ENEMY, &&op_JF_TURN_LESS, &&op_JF_SEEN, &&op_JF_SCAN_LE, &&op_JF_NEAR_SIGNAL,
+        &&op_JF_DAMAGED, &&op_JF_HP_LE, &&op_JF_CAN_ATTACK, &&op_JF_NEAR_EDGE,
+        &&op_SCAN_JF_SEEN, &&op_SCAN_JF_SCAN_LE,
+    };
+    static_assert(sizeof(labels)/sizeof(labels[0]) == VM_OP_COUNT, "handler table out of sync with OpCode");
+    #define VM_OP(name) op_##name:
+    #define VM_NEXT() goto *(PROFILE ? (prof->ops[ip->op].count++, labels[ip->op]) : ip->handler)
+    if(!ip) return labels;
+#else
+    #define VM_OP(name) case OP_##name:
+    // a goto, not `continue`: VM_NEXT also runs inside the do/while(0) of
+    // VM_TRANSFER and VM_BRANCH, where `continue` would only leave that
+    #define VM_NEXT() goto dispatch
+    if(!ip) return nullptr;
+#endif
+
+    Arena &A = *bot->A;
+    const int id = bot->id;
+    Arena::BotState &b = A.bots[id];
+    const RobotInstr *prog = ip;
+    bool flag = false; // last condition
+
+    RobotProfile *prof = PROFILE ? bot->profile.get() : nullptr;
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point turnStart = PROFILE ? Clock::now() : Clock::time_point();
+    auto ns = [](Clock::time_point from){ return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - from).count(); };
+    // an Arena call, timed when profiling
+    #define VM_CALL(kind, call) do{ \
+        if(PROFILE){ Clock::time_point t0 = Clock::now(); call; prof->calls[kind].count++; prof->calls[kind].ns += ns(t0); } \
+        else { call; } }while(0)
+
+    // Metering: straight-line runs are counted in one go whenever control
+    // transfers, and the budget is checked there, so the per-instruction
+    // path pays nothing. A turn can overrun the budget by at most one
+    // jump-free stretch of the program.
+    const RobotInstr *run = ip;    // first instruction of the current straight run
+    int cycles = 0;
+    const int budget = A.cfg.instructionBudget > 0 ? A.cfg.instructionBudget : INT_MAX;
+    #define VM_TRANSFER(dest) do{ cycles += (int)(ip - run) + 1; if(cycles > budget) goto out_of_cycles; ip = run = (dest); VM_NEXT(); }while(0)
+    #define VM_BRANCH() do{ \
+        if(flag){ if(PROFILE) prof->ops[ip->op].notTaken++; ++ip; VM_NEXT(); } \
+        if(PROFILE) prof->ops[ip->op].taken++; \
+        VM_TRANSFER(prog + ip->target); }while(0)
+
+#if ROBOTS_VM_THREADED
+    VM_NEXT();
+    {
+#else
+dispatch:
+    switch(PROFILE ? (prof->ops[ip->op].count++, ip->op) : ip->op){
+#endif
+        VM_OP(WAIT) { ++ip; VM_NEXT(); }
+        VM_OP(MOVE) { VM_CALL(CALL_MOVE, A.Move(id, ip->arg)); ++ip; VM_NEXT(); }
+        VM_OP(TURN) { VM_CALL(CALL_TURN, A.Turn(id, ip->arg)); ++ip; VM_NEXT(); }
+        VM_OP(ATTACK) { VM_CALL(CALL_ATTACK, A.Attack(id, ip->arg)); ++ip; VM_NEXT(); }
+        VM_OP(SIGNAL) { VM_CALL(CALL_SIGNAL, A.Signal(id, ip->arg)); ++ip; VM_NEXT(); }
+        VM_OP(ATTACK_SCAN) { VM_CALL(CALL_ATTACK, A.AttackScan(id)); ++ip; VM_NEXT(); }
+        VM_OP(SCAN) { VM_CALL(CALL_SCAN, A.Scan(id)); ++ip; VM_NEXT(); }
+        VM_OP(TURN_SCAN) { if(b.scan_dir>=0) VM_CALL(CALL_TURN, A.Turn(id, b.scan_dir)); ++ip; VM_NEXT(); }
+        VM_OP(TURN_AWAY) { if(b.scan_dir>=0) VM_CALL(CALL_TURN, A.Turn(id, (b.scan_dir+4)%8)); ++ip; VM_NEXT(); }
+        VM_OP(TURN_RANDOM) { VM_CALL(CALL_TURN, A.Turn(id, A.RandomDirection(id))); ++ip; VM_NEXT(); }
+        VM_OP(IF_ENEMY) { VM_CALL(CALL_ENEMY_ADJACENT, flag = A.EnemyAdjacent(id, ip->arg)); ++ip; VM_NEXT(); }
+        VM_OP(IF_TURN_LESS) { flag = (turn < ip->arg); ++ip; VM_NEXT(); }
+        VM_OP(IF_SEEN) { flag = (b.scan_dist > 0); ++ip; VM_NEXT(); }
+        VM_OP(IF_SCAN_LE) { flag = (b.scan_dist > 0 && b.scan_dist <= ip->arg); ++ip; VM_NEXT(); }
+        VM_OP(IF_NEAR_SIGNAL) { VM_CALL(CALL_NEAR_SIGNAL, flag = A.HasSignalNearby(id, ip->arg)); ++ip; VM_NEXT(); }
+        VM_OP(IF_DAMAGED) { flag = b.damaged_last_turn; ++ip; VM_NEXT(); }
+        VM_OP(IF_HP_LE) { flag = (b.hp <= ip->arg); ++ip; VM_NEXT(); }
+        VM_OP(IF_CAN_ATTACK) { flag = (b.cooldown == 0); ++ip; VM_NEXT(); }
+        VM_OP(IF_NEAR_EDGE) { flag = (edgeDistance(A, b) <= ip->arg); ++ip; VM_NEXT(); }
+        VM_OP(JUMP_IF_FALSE) { VM_BRANCH(); }
+        VM_OP(JUMP) { VM_TRANSFER(prog + ip->target); }
+        VM_OP(END) {
+            cycles += (int)(ip - run) + 1;
+            VM_CALL(CALL_END_TURN, A.EndBotTurn(id, cycles, false));
+            if(PROFILE){ prof->turns++; prof->turnNs += ns(turnStart); }
+            return nullptr;
+        }
+        VM_OP(MOVE_TOWARD) { VM_CALL(CALL_MOVE_TOWARD, A.MoveToward(id, ip->arg)); ++ip; VM_NEXT(); }
+        // superinstructions
+        VM_OP(JF_ENEMY) { VM_CALL(CALL_ENEMY_ADJACENT, flag = A.EnemyAdjacent(id, ip->arg)); VM_BRANCH(); }
+        VM_OP(JF_TURN_LESS) { flag = (turn < ip->arg); VM_BRANCH(); }
+        VM_OP(JF_SEEN) { flag = (b.scan_dist > 0); VM_BRANCH(); }
+        VM_OP(JF_SCAN_LE) { flag = (b.scan_dist > 0 && b.scan_dist <= ip->arg); VM_BRANCH(); }
+        VM_OP(JF_NEAR_SIGNAL) { VM_CALL(CALL_NEAR_SIGNAL, flag = A.HasSignalNearby(id, ip->arg)); VM_BRANCH(); }
+        VM_OP(JF_DAMAGED) { flag = b.damaged_last_turn; VM_BRANCH(); }
+        VM_OP(JF_HP_LE) { flag = (b.hp <= ip->arg); VM_BRANCH(); }
+        VM_OP(JF_CAN_ATTACK) { flag = (b.cooldown == 0); VM_BRANCH(); }
+        VM_OP(JF_NEAR_EDGE) { flag = (edgeDistance(A, b) <= ip->arg); VM_BRANCH(); }
+        VM_OP(SCAN_JF_SEEN) { VM_CALL(CALL_SCAN, A.Scan(id)); flag = (b.scan_dist > 0); VM_BRANCH(); }
+        VM_OP(SCAN_JF_SCAN_LE) { VM_CALL(CALL_SCAN, A.Scan(id)); flag = (b.scan_dist > 0 && b.scan_dist <= ip->arg); VM_BRANCH(); }
+#if !ROBOTS_VM_THREADED
+        default: return nullptr;
+#endif
+    }
+out_of_cycles:
+    VM_CALL(CALL_END_TURN, A.EndBotTurn(id, cycles, true));
+    if(PROFILE){ prof->turns++; prof->turnNs += ns(turnStart); }
+    return nullptr;
+    #undef VM_OP
+    #undef VM_NEXT
+    #undef VM_CALL
+    #undef VM_TRANSFER
+    #undef VM_BRANCH
+}
+
+static bool isCondition(int op){ return op >= OP_IF_ENEMY && op <= OP_IF_NEAR_EDGE; }
+
+// Peephole pass over a lowered program (targets are instruction indices).
+// Kept instructions execute exactly as before; removed ones are either
+// no-ops or folded into the superinstruction that replaces them.
+static void optimizeProgram(std::vector<RobotInstr> &instrs){
+    const int n = (int)instrs.size();
+    std::vector<char> targeted(n, 0), dead(n, 0);
+    for(auto &in : instrs){
+        if(in.op == OP_JUMP || in.op == OP_JUMP_IF_FALSE) targeted[in.target] = 1;
+    }
+
+    // fuse SCAN + IF_SEEN/IF_SCAN_LE + JUMP_IF_FALSE, then IF_* + JUMP_IF_FALSE;
+    // never across an instruction something jumps into
+    for(int i=0; i+1<n; ++i){
+        if(dead[i]) continue;
+        RobotInstr &in = instrs[i];
+        if(in.op == OP_SCAN && i+2<n && !targeted[i+1] && !targeted[i+2] && instrs[i+2].op == OP_JUMP_IF_FALSE &&
+           (instrs[i+1].op == OP_IF_SEEN || instrs[i+1].op == OP_IF_SCAN_LE)){
+            in.op = instrs[i+1].op == OP_IF_SEEN ? OP_SCAN_JF_SEEN : OP_SCAN_JF_SCAN_LE;
+            in.arg = instrs[i+1].arg;
+            in.target = instrs[i+2].target;
+            dead[i+1] = dead[i+2] = 1;
+        } else if(isCondition(in.op) && !targeted[i+1] && instrs[i+1].op == OP_JUMP_IF_FALSE){
+            in.op = OP_JF_ENEMY + (in.op - OP_IF_ENEMY);
+            in.target = instrs[i+1].target;
+            dead[i+1] = 1;
+        }
+    }
+    // WAIT does nothing
+    for(int i=0; i<n; ++i){
+        if(instrs[i].op == OP_WAIT) dead[i] = 1;
+    }
+
+    auto nextLive = [&](int t){ while(t<n-1 && dead[t]) ++t; return t; };
+    auto isBranch = [](int op){ return op == OP_JUMP_IF_FALSE || (op >= OP_JF_ENEMY && op < VM_OP_COUNT); };
+
+    // thread jump chains: a jump landing on JUMP goes straight to its target,
+    // and a taken false-branch landing on a plain JUMP_IF_FALSE (same flag,
+    // still false) goes straight to that one's target
+    bool changed = true;
+    while(changed){
+        changed = false;
+        for(int i=0; i<n; ++i){
+            RobotInstr &in = instrs[i];
+            if(dead[i] || !(in.op == OP_JUMP || isBranch(in.op))) continue;
+            int t = nextLive(in.target);
+            for(int hops=0; hops<n; ++hops){
+                const RobotInstr &to = instrs[t];
+                if(to.op == OP_JUMP || (to.op == OP_JUMP_IF_FALSE && in.op != OP_JUMP)) t = nextLive(to.target);
+                else break;
+            }
+            if(t != in.target){ in.target = t; changed = true; }
+            if(in.op == OP_JUMP){
+                if(instrs[t].op == OP_END){ in.op = OP_END; changed = true; }
+                else if(t == nextLive(i+1)){ dead[i] = 1; changed = true; }
+            }
+        }
+    }
+
+    // drop whatever can no longer be reached
+    std::vector<char> reached(n, 0);
+    std::vector<int> work{ nextLive(0) };
+    while(!work.empty()){
+        int i = work.back(); work.pop_back();
+        if(reached[i]) continue;
+        reached[i] = 1;
+        int op = instrs[i].op;
+        if(op == OP_JUMP || isBranch(op)) work.push_back(instrs[i].target);
+        if(op != OP_JUMP && op != OP_END && i+1<n) work.push_back(nextLive(i+1));
+    }
+    for(int i=0; i<n-1; ++i){
+        if(!reached[i]) dead[i] = 1;
+    }
+    dead[n-1] = 0;  // keep the terminal OP_END
+
+    // compact and remap targets
+    std::vector<int> remap(n);
+    int kept = 0;
+    for(int i=0; i<n; ++i){
+        remap[i] = kept;
+        if(!dead[i]) kept++;
+    }
+    std::vector<RobotInstr> out;
+    out.reserve(kept);
+    for(int i=0; i<n; ++i){
+        if(dead[i]) continue;
+        RobotInstr in = instrs[i];
+        if(in.op == OP_JUMP || isBranch(in.op)) in.target = remap[nextLive(in.target)];
+        out.push_back(in);
+    }
+    instrs.swap(out);
+}
+
+std::shared_ptr<const RobotProgram> LowerProgram(const std::vector<int> &code, int scriptCost, bool optimize){
+    return LowerProgram(code.data(), (int)code.size(), scriptCost, optimize);
+}
+
+std::shared_ptr<const RobotProgram> LowerProgram(const int *code, int n, int scriptCost, bool optimize){
+    auto program = std::make_shared<RobotProgram>();
+    program->codeSize = n;
+    program->scriptCost = scriptCost;
+
+    // pass 1: find instruction boundaries, stopping where the old
+    // interpreter would have stopped
+    std::vector<int> index(n + 1, -1); // p-code offset -> instruction index
+    int pc = 0, count = 0, last = -1;
+    while(pc < n){
+        int op = code[pc];
+        if(op < 0 || op >= OP_JF_ENEMY) break;
+        int len = hasOperand(op) ? 2 : 1;
+        if(pc + len > n) break;
+        index[pc] = count++;
+        last = pc;
+        pc += len;
+    }
+    const int end = pc;
+    bool sealed = last >= 0 && code[last] == OP_END;
+    // the terminal OP_END every jump that leaves the program lands on
+    const int endIndex = sealed ? count - 1 : count;
+    index[end] = endIndex;
+
+    // pass 2: decode
+    program->instrs.reserve(endIndex + 1);
+    for(pc = 0; pc < end; ){
+        RobotInstr in;
+        in.op = code[pc];
+        if(hasOperand(in.op)) in.arg = code[pc+1];
+        if(in.op == OP_JUMP || in.op == OP_JUMP_IF_FALSE){
+            int t = in.arg;
+            in.target = (t >= 0 && t <= end && index[t] >= 0) ? index[t] : endIndex;
+            in.arg = 0;
+        }
+        pc += hasOperand(in.op) ? 2 : 1;
+        program->instrs.push_back(in);
+    }
+    if(!sealed){
+        RobotInstr in;
+        in.op = OP_END;
+        program->instrs.push_back(in);
+    }
+    program->loweredSize = (int)program->instrs.size();
+    if(optimize) optimizeProgram(program->instrs);
+
+#if ROBOTS_VM_THREADED
+    const void* const* labels = runProgram<false>(nullptr, nullptr, 0);
+    for(auto &in : program->instrs) in.handler = labels[in.op];
+#endif
+    return program;
+}
+
+const char* RobotVmDispatchName(){
+#if ROBOTS_VM_THREADED
+    return "threaded";
+#else
+    return "switch";
+#endif
+}
+
+// ===== Profiling =====
+void RobotProfile::Add(const RobotProfile &other){
+    for(int i=0; i<VM_OP_COUNT; ++i){
+        ops[i].count += other.ops[i].count;
+        ops[i].taken += other.ops[i].taken;
+        ops[i].notTaken += other.ops[i].notTaken;
+    }
+    for(int i=0; i<ARENA_CALL_COUNT; ++i){
+        calls[i].count += other.calls[i].count;
+        calls[i].ns += other.calls[i].ns;
+    }
+    turns += other.turns;
+    turnNs += other.turnNs;
+}
+
+const char* RobotVmOpName(int op){
+    static const char* const names[] = {
+        "WAIT", "MOVE", "TURN", "ATTACK", "SIGNAL", "ATTACK_SCAN", "SCAN", "TURN_SCAN", "TURN_AWAY", "TURN_RANDOM",
+        "IF_ENEMY", "IF_TURN_LESS", "IF_SEEN", "IF_SCAN_LE", "IF_NEAR_SIGNAL",
+        "IF_DAMAGED", "IF_HP_LE", "IF_CAN_ATTACK", "IF_NEAR_EDGE",
+        "JUMP_IF_FALSE", "JUMP", "END", "MOVE_TOWARD",
+        "JF_ENEMY", "JF_TURN_LESS", "JF_SEEN", "JF_SCAN_LE", "JF_NEAR_SIGNAL",
+        "JF_DAMAGED", "JF_HP_LE", "JF_CAN_ATTACK", "JF_NEAR_EDGE",
+        "SCAN_JF_SEEN", "SCAN_JF_SCAN_LE",
+    };
+    static_assert(sizeof(names)/sizeof(names[0]) == VM_OP_COUNT, "op names out of sync with OpCode");
+    return op >= 0 && op < VM_OP_COUNT ? names[op] : "?";
+}
+
+const char* RobotArenaCallName(int call){
+    static const char* const names[] = {
+        "Move", "Turn", "Attack", "Signal", "Scan", "EnemyAdjacent", "HasSignalNearby", "EndBotTurn", "MoveToward",
+    };
+    static_assert(sizeof(names)/sizeof(names[0]) == ARENA_CALL_COUNT, "call names out of sync with RobotArenaCall");
+    return call >= 0 && call < ARENA_CALL_COUNT ? names[call] : "?";
+}
+
+void AppendProfileCsv(std::string &out, const std::string &bot, const RobotProfile &profile){
+    char row[256];
+    snprintf(row, sizeof(row), "%s,turn,Run,%lld,,,%lld\n", bot.c_str(), profile.turns, profile.turnNs);
+    out += row;
+    for(int op=0; op<VM_OP_COUNT; ++op){
+        const RobotProfile::Op &o = profile.ops[op];
+        if(o.count == 0) continue;
+        snprintf(row, sizeof(row), "%s,op,%s,%lld,%lld,%lld,\n", bot.c_str(), RobotVmOpName(op), o.count, o.taken, o.notTaken);
+        out += row;
+    }
+    for(int call=0; call<ARENA_CALL_COUNT; ++call){
+        const RobotProfile::Call &c = profile.calls[call];
+        if(c.count == 0) continue;
+        snprintf(row, sizeof(row), "%s,call,%s,%lld,,,%lld\n", bot.c_str(), RobotArenaCallName(call), c.count, c.ns);
+        out += row;
+    }
+}
+
+// ===== VM entry =====
+void RobotBase::Run(int turn){
+    // a profiled bot always takes the instrumented interpreter
+    if(native && !profile){ native(*this, turn); return; }
+    // bots that never called Finalize() still run their raw p-code
+    if(!program) program = LowerProgram(code, script_cost);
+    if(profile) runProgram<true>(this, program->instrs.data(), turn);
+    else runProgram<false>(this, program->instrs.data(), turn);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ===== Lowered bot programs =====
+// The DSL macros emit flat p-code (opcode, then an operand for the ops that
+// take one). Finalize() lowers that once into a RobotInstr per operation:
+// operands already read, IF placeholders dropped, jump targets turned into
+// instruction indices and, in threaded builds, the address of the op's
+// handler stored inline so dispatch is a single indirect jump.
+//
+// Threaded dispatch needs GCC/Clang computed goto; other compilers (or a
+// build with ROBOTS_VM_SWITCH defined) run the same handlers from a switch.
+//
+// A peephole pass then fuses the sequences the macros always produce into
+// superinstructions, drops no-op instructions and threads jump chains.
+// It only changes the instruction stream: behaviour and script_cost stay
+// exactly those of the p-code.
+
+// superinstructions; these only exist in lowered programs, never in p-code
+enum VmOpCode {
+    // IF_* + JUMP_IF_FALSE: set the flag, then branch to target when false
+    // (same order as OP_IF_ENEMY..OP_IF_NEAR_EDGE)
+    OP_JF_ENEMY = 23, OP_JF_TURN_LESS, OP_JF_SEEN, OP_JF_SCAN_LE, OP_JF_NEAR_SIGNAL,
+    OP_JF_DAMAGED, OP_JF_HP_LE, OP_JF_CAN_ATTACK, OP_JF_NEAR_EDGE,
+    // SCAN + IF_SEEN / IF_SCAN_LE + JUMP_IF_FALSE
+    OP_SCAN_JF_SEEN, OP_SCAN_JF_SCAN_LE,
+    VM_OP_COUNT
+};
+
+struct RobotInstr {
+    const void* handler = nullptr;  // computed-goto label, threaded builds only
+    int op = 0;                     // OpCode or VmOpCode
+    int arg = 0;                    // operand, 0 for ops that take none
+    int target = 0;                 // jump destination as an instruction index
+};
+
+struct RobotProgram {
+    std::vector<RobotInstr> instrs; // always ends in OP_END
+    int codeSize = 0;               // p-code ints it was lowered from
+    int loweredSize = 0;            // instructions before the peephole pass
+    int scriptCost = 0;
+};
+
+// Lower p-code as emitted by the macros. Anything the old interpreter would
+// have stopped on (unknown opcode, truncated operand, jump outside the code)
+// becomes OP_END; jumps into the middle of an instruction, which the macros
+// never emit, do too. `optimize` = false skips the peephole pass.
+std::shared_ptr<const RobotProgram> LowerProgram(const std::vector<int> &code, int scriptCost, bool optimize = true);
+// the same from `n` ints anywhere in memory (a mapped bundle, see RobotsBundle.h)
+std::shared_ptr<const RobotProgram> LowerProgram(const int *code, int n, int scriptCost, bool optimize = true);
+
+// Whether `arg` is an operand the arena can run for p-code op `op`:
+// directions 0..7, MOVE 1..MAX_SCRIPT_COST / COST_MOVE, MOVE_TOWARD a
+// FlowTarget, SIGNAL values, radii and thresholds non-negative. Jump targets
+// and ops without an operand are not checked (LowerProgram handles those).
+bool OperandInRange(int op, int arg);
+// Checks p-code that did not come from the macros (a bundle, a script
+// cache): every operand in range, and the actions' cost equal to
+// scriptCost and within MAX_SCRIPT_COST.
+bool CheckProgramCode(const int *code, int n, int scriptCost, std::string *error = nullptr);
+
+// "threaded" or "switch"
+const char* RobotVmDispatchName();
+
+// ===== VM profiling =====
+// A bot with a RobotProfile attached (RobotBase::profile) runs on a second
+// instantiation of the interpreter that counts every instruction executed,
+// the outcome of every conditional branch and the time spent inside each
+// Arena call. Bots without one run the plain interpreter, which is compiled
+// without any of that, so profiling costs nothing while it is off.
+// Natively compiled bots fall back to the interpreter while profiled.
+//
+// Counts are per lowered instruction: in optimized programs the IF_* +
+// JUMP_IF_FALSE pairs show up as the fused OP_JF_* / OP_SCAN_JF_* ops.
+// "taken" is the false-branch jump, "not taken" falls through into the
+// IF body.
+enum RobotArenaCall {
+    CALL_MOVE, CALL_TURN, CALL_ATTACK, CALL_SIGNAL, CALL_SCAN,
+    CALL_ENEMY_ADJACENT, CALL_NEAR_SIGNAL, CALL_END_TURN, CALL_MOVE_TOWARD,
+    ARENA_CALL_COUNT
+};
+
+struct RobotProfile {
+    struct Op { long long count = 0, taken = 0, notTaken = 0; };
+    struct Call { long long count = 0, ns = 0; };
+    std::array<Op, VM_OP_COUNT> ops;
+    std::array<Call, ARENA_CALL_COUNT> calls;
+    long long turns = 0;
+    long long turnNs = 0;           // whole Run(), Arena calls included
+
+    void Add(const RobotProfile &other);
+};
+
+const char* RobotVmOpName(int op);          // "MOVE", "JF_SEEN", ...
+const char* RobotArenaCallName(int call);   // "Move", "HasSignalNearby", ...
+
+// one CSV row per executed op and per Arena call made, plus a "turn" row:
+//   bot,kind,name,count,taken,not_taken,ns
+// (ROBOT_PROFILE_CSV_HEADER is the header line)
+static constexpr const char* ROBOT_PROFILE_CSV_HEADER = "bot,kind,name,count,taken,not_taken,ns\n";
+void AppendProfileCsv(std::string &out, const std::string &bot, const RobotProfile &profile);
@@ -28,6 +28,17 @@ bool Sprite::LoadTextureFromFile(const char* filename)
     return true;
 }
 
+bool Sprite::LoadTextureFromPixels(const unsigned char* rgba, int width, int height)
+{
+    _texture = _loadTextureFromMemory(rgba, width, height);
+    if (_texture == 0) {
+        _size = ImVec2(0, 0);
+        return false;
+    }
+    _size = ImVec2((float)width, (float)height);
+    return true;
+}
+
 void Sprite::setHighlighted(bool highlighted)
 {
 	if (highlighted != _highlighted) {
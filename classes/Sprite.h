@@ -77,6 +77,11 @@ public:
     }
 
     bool LoadTextureFromFile(const char* filename);
+    // upload RGBA pixels built in memory (4 bytes per pixel, rows top to bottom)
+    bool LoadTextureFromPixels(const unsigned char* rgba, int width, int height);
+    // share a texture another sprite already loaded
+    ImTextureID getTexture() const { return _texture; }
+    void setTexture(ImTextureID texture) { _texture = texture; }
 	
     // set the highlighted state
 	virtual void	setHighlighted(bool yes);
@@ -0,0 +1,114 @@
+#include "WorkStealingPool.h"
+
+// index of the calling worker in its pool, -1 on non-pool threads
+static thread_local int t_workerIndex = -1;
+static thread_local const WorkStealingPool* t_workerPool = nullptr;
+
+WorkStealingPool::WorkStealingPool(unsigned threads)
+{
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        _queues.emplace_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        _threads.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    Wait();
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _wake.notify_all();
+    for (auto &t : _threads) {
+        t.join();
+    }
+}
+
+void WorkStealingPool::Submit(std::function<void()> task)
+{
+    unsigned target;
+    if (t_workerPool == this) {
+        target = (unsigned)t_workerIndex;
+    } else {
+        target = _nextQueue.fetch_add(1, std::memory_order_relaxed) % (unsigned)_queues.size();
+    }
+
+    _pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(_queues[target]->mutex);
+        _queues[target]->tasks.push_back(std::move(task));
+    }
+    {
+        // taking the sleep lock orders this against a worker about to wait
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _queued.fetch_add(1);
+    }
+    _wake.notify_one();
+}
+
+void WorkStealingPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _idle.wait(lock, [this] { return _pending.load() == 0; });
+}
+
+bool WorkStealingPool::popOrSteal(unsigned self, std::function<void()> &task)
+{
+    // own deque first, newest task (still warm in cache)
+    {
+        Queue &q = *_queues[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            return true;
+        }
+    }
+    // then steal the oldest task from the other workers
+    unsigned n = (unsigned)_queues.size();
+    for (unsigned k = 1; k < n; ++k) {
+        Queue &q = *_queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(unsigned self)
+{
+    t_workerIndex = (int)self;
+    t_workerPool = this;
+
+    std::function<void()> task;
+    while (true) {
+        if (popOrSteal(self, task)) {
+            _queued.fetch_sub(1);
+            task();
+            task = nullptr;
+            if (_pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(_sleepMutex);
+                _idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _wake.wait(lock, [this] { return _stop || _queued.load() > 0; });
+        if (_stop && _queued.load() == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ===== WorkStealingPool: fixed set of workers, one deque each =====
+// Workers pop from the back of their own deque and steal from the front of
+// the others when they run dry, so uneven task lengths (short wipe-outs vs.
+// full-length draws) still keep every core busy.
+class WorkStealingPool
+{
+public:
+    explicit WorkStealingPool(unsigned threads = 0);   // 0 = one per core
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // queue a task; tasks submitted from a worker go to that worker's deque
+    void Submit(std::function<void()> task);
+    // block until every submitted task has finished
+    void Wait();
+
+    unsigned Size() const { return (unsigned)_threads.size(); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popOrSteal(unsigned self, std::function<void()> &task);
+    void workerLoop(unsigned self);
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+    std::condition_variable _idle;
+    std::atomic<int> _queued{0};     // tasks sitting in a deque
+    std::atomic<int> _pending{0};    // tasks queued or running
+    std::atomic<unsigned> _nextQueue{0};
+    bool _stop = false;
+};
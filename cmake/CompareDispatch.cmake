@@ -0,0 +1,24 @@
+# Plays the same matches on robots_sim (threaded dispatch where the compiler
+# has computed goto) and robots_sim_switch, and fails unless every match ends
+# the same way. Run by ctest; -DTHREADED and -DSWITCH are the two binaries.
+function(play sim seed mode result)
+    execute_process(COMMAND ${sim} -n 200 -v --seed ${seed} ${mode}
+                    OUTPUT_VARIABLE out RESULT_VARIABLE code)
+    if(NOT code EQUAL 0)
+        message(FATAL_ERROR "${sim} exited with ${code}")
+    endif()
+    # the per-match lines only; the summary carries timings
+    string(REGEX MATCHALL "\nmatch [0-9]+ [^\n]*" lines "\n${out}")
+    set(${result} "${lines}" PARENT_SCOPE)
+endfunction()
+
+foreach(seed 5 7)
+    foreach(mode "" "--simultaneous")
+        play(${THREADED} ${seed} "${mode}" threaded)
+        play(${SWITCH} ${seed} "${mode}" switched)
+        if(threaded STREQUAL "" OR NOT threaded STREQUAL switched)
+            message(FATAL_ERROR "switch dispatch differs from threaded dispatch (seed ${seed} ${mode})")
+        endif()
+    endforeach()
+endforeach()
+message(STATUS "switch dispatch matches threaded dispatch")
@@ -0,0 +1,1201 @@
+// robots_bench: headless Robots performance benchmarks
+//
+//   robots_bench scale [--sizes 64,256,1024] [--bots 100,1000,10000] [-t turns] [--seed S] [--events]
+//                      [--simultaneous] [-j threads]
+//   robots_bench scan [--sizes 64,256,1024] [--bots 100,1000,10000] [-r reps] [--seed S]
+//   robots_bench signal [--sizes 64,256,1024] [--bots 100,1000,10000] [-r reps] [--seed S]
+//   robots_bench flow [--sizes 64,256] [--bots 100,1000] [-r reps] [--seed S]
+//   robots_bench vm [--size W] [--bots N] [-t turns] [-r reps] [--seed S]
+//   robots_bench replay [--size W] [--bots N] [-t turns] [-k 1,4,16,64] [-r seeks] [--seed S]
+//   robots_bench native [--size W] [--bots N] [-t turns] [-n matches] [--budget N] [--seed S]
+//   robots_bench bundle [--entrants N] [-n matches] [-t turns] [--seed S] [-o file]
+//   robots_bench script [--entrants N] [--seed S] [-o dir]
+//
+// scale: turn latency as the board and the population grow. Bots are cloned
+// round-robin from the class roster onto a runtime-sized arena. --events
+// attaches an event log, as the Robots window does. --simultaneous plays
+// simultaneous-move turns, planning the bots on -j threads.
+// scan: every bot scans once, with the original per-bot loop and with each
+// kernel in RobotsScan.h; results are checked against the original.
+// signal: every bot asks HasSignalNearby at several radii after a turn in
+// which everyone signaled, with the original walk and with the bucket index.
+// flow: the steps from every bot to its nearest enemy, signal and the board
+// center, with a BFS per bot and from the arena's shared flow fields (one
+// BFS per target, see Arena::MoveToward); the distances must agree.
+// vm: per-instruction cost of the lowered interpreter, with and without the
+// peephole pass, against the original switch over raw p-code, on a
+// pure-dispatch probe script and on real matches (which must end in the same
+// state), plus the code size of each roster bot at every stage.
+// replay: file size and random-seek time of a recorded match for several
+// keyframe intervals, against a plain-text state line per turn; every seek
+// is checked against the state captured live, and so is re-recording after a
+// Truncate.
+// native: the class roster as macro bots on the interpreter against the
+// RobotsNative.h programs, interpreted and compiled: the p-code must be
+// identical and every match must end in the same state (cycle counts
+// included), on class-size matches and on a large board.
+// bundle: short 1v1 matches between random pairs of N entrants (copies of
+// the class bots), set up from the roster and from a bot bundle (see
+// RobotsBundle.h) written to -o; setup time is reported apart from play,
+// and every match must end in the same state.
+// script: N random bots (an evolve generation 0) written as .bot scripts to
+// -o, then loaded without a cache, into an empty cache, from the warm cache
+// and with one script edited (see RobotsScript.h); every loaded program must
+// match the one the macros compile for the same statements, only the edited
+// script may recompile, and scripts with operands the arena cannot run must
+// be rejected.
+
+#include "classes/RobotsBundle.h"
+#include "classes/RobotsMatch.h"
+#include "classes/RobotsNative.h"
+#include "classes/RobotsReplay.h"
+#include "classes/RobotsScript.h"
+#include "classes/WorkStealingPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+static void usage(const char* exe)
+{
+    printf("usage: %s scale [--sizes W,...] [--bots N,...] [-t turns] [--seed S] [--events] [--simultaneous] [-j threads]\n", exe);
+    printf("       %s scan [--sizes W,...] [--bots N,...] [-r reps] [--seed S]\n", exe);
+    printf("       %s signal [--sizes W,...] [--bots N,...] [-r reps] [--seed S]\n", exe);
+    printf("       %s flow [--sizes W,...] [--bots N,...] [-r reps] [--seed S]\n", exe);
+    printf("       %s vm [--size W] [--bots N] [-t turns] [-r reps] [--seed S]\n", exe);
+    printf("       %s replay [--size W] [--bots N] [-t turns] [-k K,...] [-r seeks] [--seed S]\n", exe);
+    printf("       %s native [--size W] [--bots N] [-t turns] [-n matches] [--budget N] [--seed S]\n", exe);
+    printf("       %s bundle [--entrants N] [-n matches] [-t turns] [--seed S] [-o file]\n", exe);
+    printf("       %s script [--entrants N] [--seed S] [-o dir]\n", exe);
+    printf("  --sizes     square board sizes to try (default 64,256,1024, flow: 64,256)\n");
+    printf("  --bots      population sizes to try (default 100,1000,10000, flow: 100,1000)\n");
+    printf("  --size W    square board size for vm, replay and native (default 256)\n");
+    printf("  -n N        class-size matches per roster for native (default 20000)\n");
+    printf("  --budget N  VM instructions per bot turn for native (default %d)\n", MAX_TURN_INSTRUCTIONS);
+    printf("  -k K,...    replay keyframe intervals to try (default 1,4,16,64)\n");
+    printf("  --entrants N  bots in the bundle and script workloads (default 4096, script 500)\n");
+    printf("  -o FILE     bundle file to write (default bench.rbb)\n");
+    printf("              (script: directory to write the scripts to, default bench_bots)\n");
+    printf("  -t N        turns to time per configuration (default 10, vm: 40, replay: 200)\n");
+    printf("  -r N        sweeps to time per variant (default 5, vm probe: 200000 runs, replay: 2000 seeks)\n");
+    printf("  --seed S    match seed (default 1)\n");
+    printf("  --events    record arena events while timing scale\n");
+    printf("  --simultaneous  time simultaneous-move turns\n");
+    printf("  -j N        threads planning simultaneous turns (default: one per core)\n");
+}
+
+static std::vector<int> parseList(const char* s)
+{
+    std::vector<int> v;
+    while (*s) {
+        v.push_back(atoi(s));
+        const char* comma = strchr(s, ',');
+        if (!comma) break;
+        s = comma + 1;
+    }
+    return v;
+}
+
+static double msSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static int benchScale(int argc, char** argv)
+{
+    std::vector<int> sizes = {64, 256, 1024};
+    std::vector<int> populations = {100, 1000, 10000};
+    int turns = 10;
+    uint64_t seed = 1;
+    bool events = false;
+    bool simultaneous = false;
+    unsigned threads = 0;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            sizes = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "--bots") && i + 1 < argc) {
+            populations = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            turns = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--events")) {
+            events = true;
+        } else if (!strcmp(argv[i], "--simultaneous")) {
+            simultaneous = true;
+        } else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            threads = (unsigned)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (turns <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<RobotEntry> roster = ClassRoster();
+    std::unique_ptr<WorkStealingPool> pool;
+    if (simultaneous) {
+        pool.reset(new WorkStealingPool(threads));
+        printf("simultaneous turns, %u planning threads\n", pool->Size());
+    }
+    printf("%10s %8s %10s %12s %12s %14s\n", "board", "bots", "setup ms", "turn ms", "max turn ms", "bot-turns/s");
+    for (int size : sizes) {
+        for (int count : populations) {
+            if (size <= 0 || count <= 0 || (long long)count > (long long)size * size) continue;
+
+            ArenaConfig config;
+            config.width = config.height = size;
+            config.botCount = count;
+            config.maxTurns = turns;
+            config.simultaneous = simultaneous;
+
+            auto setupStart = std::chrono::steady_clock::now();
+            RobotsMatch match;
+            match.Setup(roster, seed, config);
+            match.pool = pool.get();
+            double setupMs = msSince(setupStart);
+            RobotsEventLog log;
+            if (events) match.arena.events = &log;
+
+            double totalMs = 0.0, maxMs = 0.0;
+            long long botTurns = 0;
+            int played = 0;
+            while (match.running && played < turns) {
+                int alive = match.AliveCount();
+                auto turnStart = std::chrono::steady_clock::now();
+                match.Step();
+                double ms = msSince(turnStart);
+                totalMs += ms;
+                maxMs = std::max(maxMs, ms);
+                botTurns += alive;
+                played++;
+            }
+
+            char board[32];
+            snprintf(board, sizeof(board), "%dx%d", size, size);
+            printf("%10s %8d %10.2f %12.3f %12.3f %14.0f\n", board, count, setupMs,
+                   played ? totalMs / played : 0.0, maxMs, totalMs > 0.0 ? botTurns / (totalMs / 1000.0) : 0.0);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
+
+// the Arena::Scan loop as it was before the kernels, kept as the reference
+static ScanHit referenceScan(const Arena &A, int self)
+{
+    const auto &b = A.bots[self];
+    ScanHit hit;
+    for (int i = 0; i < (int)A.bots.size(); ++i) {
+        if (i == self) continue;
+        const auto &o = A.bots[i];
+        if (!o.alive) continue;
+        int dist = std::max(std::abs(o.x - b.x), std::abs(o.y - b.y));
+        if (dist == 0 || dist > A.cfg.scanRange) continue;
+        if (hit.dist == 0 || dist < hit.dist) {
+            hit.dist = dist;
+            hit.index = i;
+        }
+    }
+    return hit;
+}
+
+static int benchScan(int argc, char** argv)
+{
+    std::vector<int> sizes = {64, 256, 1024};
+    std::vector<int> populations = {100, 1000, 10000};
+    int reps = 5;
+    uint64_t seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            sizes = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "--bots") && i + 1 < argc) {
+            populations = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (reps <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<RobotEntry> roster = ClassRoster();
+    printf("vector kernel: %s; times are ms per sweep (every live bot scans once)\n", ScanKernelName());
+    printf("%10s %8s %10s %10s %10s %10s %10s %10s %6s\n", "board", "bots", "original", "scalar", "simd", "grid", "Scan()", "ScanAll()", "same");
+    for (int size : sizes) {
+        for (int count : populations) {
+            if (size <= 0 || count <= 0 || (long long)count > (long long)size * size) continue;
+
+            ArenaConfig config;
+            config.width = config.height = size;
+            config.botCount = count;
+            RobotsMatch match;
+            match.Setup(roster, seed, config);
+            match.Step();    // one real turn so some bots have moved or died
+            Arena &A = match.arena;
+            int n = (int)A.bots.size();
+
+            std::vector<ScanHit> expected(n);
+            bool same = true;
+            auto check = [&](int i, const ScanHit &hit) {
+                if (hit.dist != expected[i].dist || hit.index != expected[i].index) same = false;
+            };
+            auto time = [&](auto &&sweep) {
+                auto start = std::chrono::steady_clock::now();
+                for (int r = 0; r < reps; ++r) sweep();
+                return msSince(start) / reps;
+            };
+
+            double original = time([&] {
+                for (int i = 0; i < n; ++i) if (A.bots[i].alive) expected[i] = referenceScan(A, i);
+            });
+            double scalar = time([&] {
+                for (int i = 0; i < n; ++i) if (A.bots[i].alive) check(i, ScanNearestScalar(A.posX.data(), A.posY.data(), n, A.bots[i].x, A.bots[i].y, A.cfg.scanRange));
+            });
+            double simd = time([&] {
+                for (int i = 0; i < n; ++i) if (A.bots[i].alive) check(i, ScanNearestSimd(A.posX.data(), A.posY.data(), n, A.bots[i].x, A.bots[i].y, A.cfg.scanRange));
+            });
+            double grid = time([&] {
+                for (int i = 0; i < n; ++i) if (A.bots[i].alive) check(i, ScanNearestGrid(A.occupancy.data(), A.cfg.width, A.cfg.height, A.bots[i].x, A.bots[i].y, A.cfg.scanRange));
+            });
+            auto checkBot = [&](int i) {
+                const auto &b = A.bots[i];
+                int dir = expected[i].index >= 0 ? ScanDirection(A.bots[expected[i].index].x - b.x, A.bots[expected[i].index].y - b.y) : -1;
+                if (b.scan_dist != expected[i].dist || b.scan_dir != dir) same = false;
+            };
+            double scan = time([&] {
+                for (int i = 0; i < n; ++i) if (A.bots[i].alive) A.Scan(i);
+            });
+            for (int i = 0; i < n; ++i) if (A.bots[i].alive) checkBot(i);
+            A.batchScan = true;
+            double batch = time([&] {
+                A.ScanAll();
+                for (int i = 0; i < n; ++i) if (A.bots[i].alive) A.Scan(i);
+            });
+            A.batchScan = false;
+            for (int i = 0; i < n; ++i) if (A.bots[i].alive) checkBot(i);
+
+            char board[32];
+            snprintf(board, sizeof(board), "%dx%d", size, size);
+            printf("%10s %8d %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %6s\n", board, count,
+                   original, scalar, simd, grid, scan, batch, same ? "yes" : "NO");
+            fflush(stdout);
+            if (!same) return 2;
+        }
+    }
+    return 0;
+}
+
+// the Arena::HasSignalNearby loop as it was before the bucket index
+static bool referenceSignalNearby(const Arena &A, int self, int radius)
+{
+    const auto &b = A.bots[self];
+    for (auto &p : A.signals) {
+        int dist = std::max(std::abs(p.first - b.x), std::abs(p.second - b.y));
+        if (dist <= radius) return true;
+    }
+    return false;
+}
+
+static int benchSignal(int argc, char** argv)
+{
+    std::vector<int> sizes = {64, 256, 1024};
+    std::vector<int> populations = {100, 1000, 10000};
+    int reps = 5;
+    uint64_t seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            sizes = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "--bots") && i + 1 < argc) {
+            populations = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (reps <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    const int radii[] = {0, 1, 2, 3, 5, 10, 40};
+    std::vector<RobotEntry> roster = ClassRoster();
+    printf("times are ms per sweep (every live bot queries radii 0,1,2,3,5,10,40)\n");
+    printf("%10s %8s %8s %10s %10s %10s %6s\n", "board", "bots", "signals", "original", "indexed", "speedup", "same");
+    for (int size : sizes) {
+        for (int count : populations) {
+            if (size <= 0 || count <= 0 || (long long)count > (long long)size * size) continue;
+
+            ArenaConfig config;
+            config.width = config.height = size;
+            config.botCount = count;
+            RobotsMatch match;
+            match.Setup(roster, seed, config);
+            match.Step();    // leaves the signals of one real turn in place
+            Arena &A = match.arena;
+            int n = (int)A.bots.size();
+
+            std::vector<char> expected((size_t)n * 7), got((size_t)n * 7);
+            auto time = [&](auto &&sweep) {
+                auto start = std::chrono::steady_clock::now();
+                for (int r = 0; r < reps; ++r) sweep();
+                return msSince(start) / reps;
+            };
+            double original = time([&] {
+                for (int i = 0; i < n; ++i) {
+                    if (!A.bots[i].alive) continue;
+                    for (int k = 0; k < 7; ++k) expected[(size_t)i * 7 + k] = referenceSignalNearby(A, i, radii[k]);
+                }
+            });
+            double indexed = time([&] {
+                for (int i = 0; i < n; ++i) {
+                    if (!A.bots[i].alive) continue;
+                    for (int k = 0; k < 7; ++k) got[(size_t)i * 7 + k] = A.HasSignalNearby(i, radii[k]);
+                }
+            });
+            bool same = expected == got;
+
+            char board[32];
+            snprintf(board, sizeof(board), "%dx%d", size, size);
+            printf("%10s %8d %8d %10.3f %10.3f %9.1fx %6s\n", board, count, (int)A.signals.size(),
+                   original, indexed, indexed > 0.0 ? original / indexed : 0.0, same ? "yes" : "NO");
+            fflush(stdout);
+            if (!same) return 2;
+        }
+    }
+    return 0;
+}
+
+// what each bot would do without shared fields: its own BFS over free cells
+// to the nearest goal of `target`; `seen` is scratch, stamped per search
+static int searchFrom(const Arena &A, int self, int target, std::vector<unsigned> &seen, unsigned &stamp, std::vector<int> &queue)
+{
+    const int W = A.cfg.width, H = A.cfg.height;
+    auto goal = [&](int x, int y) {
+        if (target == TOWARD_ENEMY) {
+            int t = A.occupancy[y * W + x];
+            return t != -1 && t != self;
+        }
+        if (target == TOWARD_CENTER) return x >= (W - 1) / 2 && x <= W / 2 && y >= (H - 1) / 2 && y <= H / 2;
+        for (auto &p : A.signals) {
+            if (p.first == x && p.second == y) return true;
+        }
+        return false;
+    };
+    const auto &b = A.bots[self];
+    if (goal(b.x, b.y)) return 0;
+    if (++stamp == 0) {
+        std::fill(seen.begin(), seen.end(), 0u);
+        stamp = 1;
+    }
+    queue.clear();
+    queue.push_back(b.y * W + b.x);
+    seen[queue.back()] = stamp;
+    int steps = 0;      // of the cells in queue[.. levelEnd)
+    for (size_t head = 0, levelEnd = 1; head < queue.size(); ++head) {
+        if (head == levelEnd) {
+            steps++;
+            levelEnd = queue.size();
+        }
+        int x = queue[head] % W, y = queue[head] / W;
+        for (int d = 0; d < 8; ++d) {
+            int nx = x + A.dx[d], ny = y + A.dy[d];
+            if (nx < 0 || ny < 0 || nx >= W || ny >= H) continue;
+            int cell = ny * W + nx;
+            if (seen[cell] == stamp) continue;
+            seen[cell] = stamp;
+            if (goal(nx, ny)) return steps + 1;
+            if (A.occupancy[cell] == -1) queue.push_back(cell);
+        }
+    }
+    return Arena::FLOW_FAR;
+}
+
+static int benchFlow(int argc, char** argv)
+{
+    std::vector<int> sizes = {64, 256};
+    std::vector<int> populations = {100, 1000};
+    int reps = 5;
+    uint64_t seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            sizes = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "--bots") && i + 1 < argc) {
+            populations = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (reps <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<RobotEntry> roster = ClassRoster();
+    printf("times are ms per sweep (every live bot: steps to the nearest enemy, signal and center)\n");
+    printf("%10s %8s %8s %10s %10s %10s %6s\n", "board", "bots", "signals", "per-bot", "shared", "speedup", "same");
+    for (int size : sizes) {
+        for (int count : populations) {
+            if (size <= 0 || count <= 0 || (long long)count > (long long)size * size) continue;
+
+            ArenaConfig config;
+            config.width = config.height = size;
+            config.botCount = count;
+            RobotsMatch match;
+            match.Setup(roster, seed, config);
+            match.Step();    // leaves the signals of one real turn in place
+            const Arena &A = match.arena;
+            int n = (int)A.bots.size();
+
+            std::vector<int> expected((size_t)n * FLOW_TARGET_COUNT), got((size_t)n * FLOW_TARGET_COUNT);
+            std::vector<unsigned> seen((size_t)size * size, 0u);
+            std::vector<int> queue;
+            unsigned stamp = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r) {
+                for (int i = 0; i < n; ++i) {
+                    if (!A.bots[i].alive) continue;
+                    for (int t = 0; t < FLOW_TARGET_COUNT; ++t) expected[(size_t)i * FLOW_TARGET_COUNT + t] = searchFrom(A, i, t, seen, stamp, queue);
+                }
+            }
+            double perBot = msSince(start) / reps;
+
+            // a fresh copy per sweep, so every sweep builds its fields
+            std::vector<Arena> copies(reps, A);
+            start = std::chrono::steady_clock::now();
+            for (Arena &C : copies) {
+                for (int i = 0; i < n; ++i) {
+                    if (!C.bots[i].alive) continue;
+                    const auto &b = C.bots[i];
+                    for (int t = 0; t < FLOW_TARGET_COUNT; ++t) {
+                        int steps = C.FlowSteps(t, b.x, b.y, i);
+                        if (steps != 0) {
+                            steps = Arena::FLOW_FAR;
+                            for (int d = 0; d < 8; ++d) steps = std::min(steps, C.FlowSteps(t, b.x + C.dx[d], b.y + C.dy[d], i));
+                            if (steps != Arena::FLOW_FAR) steps++;
+                        }
+                        got[(size_t)i * FLOW_TARGET_COUNT + t] = steps;
+                    }
+                }
+            }
+            double shared = msSince(start) / reps;
+            bool same = expected == got;
+
+            char board[32];
+            snprintf(board, sizeof(board), "%dx%d", size, size);
+            printf("%10s %8d %8d %10.3f %10.3f %9.1fx %6s\n", board, count, (int)A.signals.size(),
+                   perBot, shared, shared > 0.0 ? perBot / shared : 0.0, same ? "yes" : "NO");
+            fflush(stdout);
+            if (!same) return 2;
+        }
+    }
+    return 0;
+}
+
+// RobotBase::Run as it was before Finalize() lowered the program, counting
+// the instructions it executes
+static void referenceRun(RobotBase &bot, int turn, long long &executed)
+{
+    const std::vector<int> &code = bot.code;
+    Arena *A = bot.A;
+    int id = bot.id;
+    int pc = 0; bool flag = false;
+    while (pc < (int)code.size()) {
+        int op = code[pc++];
+        executed++;
+        switch (op) {
+            case OP_WAIT: break;
+            case OP_MOVE: { int n = code[pc++]; A->Move(id, n); break; }
+            case OP_TURN: { int d = code[pc++]; A->Turn(id, d); break; }
+            case OP_ATTACK: { int d = code[pc++]; A->Attack(id, d); break; }
+            case OP_ATTACK_SCAN: { A->AttackScan(id); break; }
+            case OP_SIGNAL: { int v = code[pc++]; A->Signal(id, v); break; }
+            case OP_SCAN: { A->Scan(id); break; }
+            case OP_TURN_SCAN: { int d = A->bots[id].scan_dir; if (d >= 0) A->Turn(id, d); break; }
+            case OP_TURN_AWAY: { int d = A->bots[id].scan_dir; if (d >= 0) A->Turn(id, (d + 4) % 8); break; }
+            case OP_TURN_RANDOM: { A->Turn(id, A->rng.Range(0, 7)); break; }
+            case OP_IF_ENEMY: { int d = code[pc++]; flag = A->EnemyAdjacent(id, d); break; }
+            case OP_IF_TURN_LESS: { int t = code[pc++]; flag = (turn < t); break; }
+            case OP_IF_SEEN: { pc++; flag = (A->bots[id].scan_dist > 0); break; }
+            case OP_IF_SCAN_LE: { int r = code[pc++]; flag = (A->bots[id].scan_dist > 0 && A->bots[id].scan_dist <= r); break; }
+            case OP_IF_NEAR_SIGNAL: { int r = code[pc++]; flag = A->HasSignalNearby(id, r); break; }
+            case OP_IF_DAMAGED: { pc++; flag = A->bots[id].damaged_last_turn; break; }
+            case OP_IF_HP_LE: { int n = code[pc++]; flag = (A->bots[id].hp <= n); break; }
+            case OP_IF_CAN_ATTACK: { pc++; flag = (A->bots[id].cooldown == 0); break; }
+            case OP_IF_NEAR_EDGE: {
+                int r = code[pc++];
+                auto &b = A->bots[id];
+                int m = std::min(std::min(b.x, A->cfg.width - 1 - b.x), std::min(b.y, A->cfg.height - 1 - b.y));
+                flag = (m <= r);
+                break;
+            }
+            case OP_JUMP_IF_FALSE: { int tgt = code[pc++]; if (!flag) pc = tgt; break; }
+            case OP_JUMP: { int tgt = code[pc++]; pc = tgt; break; }
+            case OP_END: return;
+            default: return;
+        }
+    }
+}
+
+// conditions and jumps only, so the probe measures dispatch and nothing else
+struct DispatchProbe : RobotBase {
+    DispatchProbe() { name = "Probe"; }
+    int SetupRobot() override
+    {
+        for (int i = 0; i < 32; ++i) {
+            IF_TURN_LT(1000) {
+                WAIT_();
+            } ELSE() {
+                WAIT_();
+            }
+            IF_HP_LE(0) {
+                WAIT_();
+            }
+        }
+        return Finalize();
+    }
+};
+
+static bool sameState(const Arena &a, const Arena &b)
+{
+    if (a.bots.size() != b.bots.size()) return false;
+    for (size_t i = 0; i < a.bots.size(); ++i) {
+        const auto &x = a.bots[i], &y = b.bots[i];
+        if (x.x != y.x || x.y != y.y || x.dir != y.dir || x.hp != y.hp || x.alive != y.alive ||
+            x.cooldown != y.cooldown || x.scan_dist != y.scan_dist || x.scan_dir != y.scan_dir) return false;
+    }
+    return true;
+}
+
+static int benchVm(int argc, char** argv)
+{
+    int size = 256;
+    int count = 1000;
+    int turns = 40;
+    int reps = 200000;
+    uint64_t seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--bots") && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            turns = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (size <= 0 || count <= 0 || turns <= 0 || reps <= 0 || (long long)count > (long long)size * size) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    printf("dispatch: %s\n", RobotVmDispatchName());
+    printf("%-12s %6s %8s %8s %10s\n", "bot", "cost", "p-code", "lowered", "optimized");
+    for (auto &entry : ClassRoster()) {
+        std::unique_ptr<RobotBase> bot = entry.make();
+        bot->SetupRobot();
+        printf("%-12s %6d %8d %8d %10d\n", bot->name.c_str(), bot->script_cost, bot->program->codeSize,
+               bot->program->loweredSize, (int)bot->program->instrs.size());
+    }
+
+    // "plain" is the lowered program without the peephole pass; ns/op is per
+    // p-code instruction the original interpreter executed, for all three
+    printf("%-12s %10s %10s %10s %10s %10s %10s %10s %6s\n", "workload", "instrs", "orig ms", "plain ms", "opt ms",
+           "orig ns/op", "plain", "opt", "same");
+    auto unoptimize = [](RobotsMatch &match) {
+        for (auto &bot : match.bots) bot->program = LowerProgram(bot->code, bot->script_cost, false);
+    };
+    auto report = [](const char* label, long long executed, const double ms[3], bool same) {
+        printf("%-12s %10lld %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %6s\n", label, executed, ms[0], ms[1], ms[2],
+               ms[0] * 1e6 / executed, ms[1] * 1e6 / executed, ms[2] * 1e6 / executed, same ? "yes" : "NO");
+    };
+
+    // pure dispatch
+    {
+        RobotsMatch matches[3];
+        for (auto &match : matches) {
+            std::vector<std::unique_ptr<RobotBase>> probes;
+            probes.emplace_back(std::make_unique<DispatchProbe>());
+            probes.emplace_back(std::make_unique<DispatchProbe>());
+            match.Setup(std::move(probes), seed);
+        }
+        unoptimize(matches[1]);
+
+        long long executed = 0;
+        double ms[3];
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) referenceRun(*matches[0].bots[0], 1, executed);
+        ms[0] = msSince(start);
+        for (int k = 1; k < 3; ++k) {
+            RobotBase &bot = *matches[k].bots[0];
+            start = std::chrono::steady_clock::now();
+            for (int r = 0; r < reps; ++r) bot.Run(1);
+            ms[k] = msSince(start);
+        }
+        report("probe", executed, ms, true);
+    }
+
+    // real matches: same roster, seed and config, one stepped per interpreter
+    {
+        ArenaConfig config;
+        config.width = config.height = size;
+        config.botCount = count;
+        config.maxTurns = turns;
+        std::vector<RobotEntry> roster = ClassRoster();
+        RobotsMatch matches[3];
+        for (auto &match : matches) match.Setup(roster, seed, config);
+        unoptimize(matches[1]);
+
+        long long executed = 0;
+        double ms[3] = {0.0, 0.0, 0.0};
+        bool same = true;
+        for (int t = 1; t <= turns && same; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                RobotsMatch &match = matches[k];
+                match.arena.StartTurn();
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < match.bots.size(); ++i) {
+                    if (!match.arena.bots[i].alive) continue;
+                    if (k == 0) referenceRun(*match.bots[i], t, executed);
+                    else match.bots[i]->Run(t);
+                }
+                ms[k] += msSince(start);
+            }
+            same = sameState(matches[0].arena, matches[1].arena) && sameState(matches[0].arena, matches[2].arena);
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "%d bots", count);
+        report(label, executed, ms, same);
+        if (!same) return 2;
+    }
+    return 0;
+}
+
+// the same fields RobotsSnapshot keeps
+static bool sameSnapshot(const RobotsSnapshot &a, const RobotsSnapshot &b)
+{
+    if (a.turn != b.turn || a.running != b.running || a.bots.size() != b.bots.size() || a.signals != b.signals ||
+        a.rng.state != b.rng.state || a.rng.inc != b.rng.inc) return false;
+    for (size_t i = 0; i < a.bots.size(); ++i) {
+        const Arena::BotState &x = a.bots[i], &y = b.bots[i];
+        if (x.x != y.x || x.y != y.y || x.dir != y.dir || x.hp != y.hp || x.last_hp != y.last_hp ||
+            x.damaged_last_turn != y.damaged_last_turn || x.alive != y.alive || x.scan_dist != y.scan_dist ||
+            x.scan_dir != y.scan_dir || x.cooldown != y.cooldown || x.signal != y.signal) return false;
+    }
+    return true;
+}
+
+static int benchReplay(int argc, char** argv)
+{
+    int size = 256;
+    int count = 1000;
+    int turns = 200;
+    int seeks = 2000;
+    std::vector<int> intervals = {1, 4, 16, 64};
+    uint64_t seed = 1;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--bots") && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            turns = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-k") && i + 1 < argc) {
+            intervals = parseList(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            seeks = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (size <= 0 || count <= 0 || turns <= 0 || seeks <= 0 || (long long)count > (long long)size * size) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ArenaConfig config;
+    config.width = config.height = size;
+    config.botCount = count;
+    config.maxTurns = turns;
+
+    // play once, keeping every state and the text a save-per-turn would cost
+    std::vector<RobotsSnapshot> live;
+    size_t textBytes = 0;
+    {
+        RobotsMatch match;
+        match.Setup(ClassRoster(), seed, config);
+        auto keep = [&]() {
+            live.emplace_back();
+            live.back().Capture(match);
+            textBytes += std::to_string(match.turn).size() + 1;
+            for (auto &b : match.arena.bots) {
+                textBytes += std::to_string(b.x).size() + std::to_string(b.y).size() + std::to_string(b.hp).size() +
+                             std::to_string(b.dir).size() + 6;
+            }
+        };
+        keep();
+        while (match.Step()) keep();
+        keep();
+    }
+    printf("%d bots on %dx%d, %zu recorded states, text %.1f KB\n", count, size, size, live.size(), textBytes / 1024.0);
+    printf("%6s %12s %10s %10s %10s %12s %6s\n", "K", "bytes", "vs text", "B/turn", "record ms", "seek us", "same");
+
+    for (int interval : intervals) {
+        if (interval <= 0) continue;
+
+        // record by replaying the captured states into a match
+        RobotsMatch match;
+        match.Setup(ClassRoster(), seed, config);
+        RobotsReplayWriter writer;
+        auto start = std::chrono::steady_clock::now();
+        writer.Begin(match, interval);
+        for (size_t t = 1; t < live.size(); ++t) {
+            live[t].Apply(match);
+            writer.Record(match);
+        }
+        std::vector<uint8_t> bytes = writer.Finish();
+        double recordMs = msSince(start);
+        size_t fileSize = bytes.size();
+
+        RobotsReplay replay;
+        std::string error;
+        if (!replay.Parse(bytes, &error)) {
+            printf("K=%d: %s\n", interval, error.c_str());
+            return 2;
+        }
+
+        // every turn once for correctness, then random turns for timing
+        bool same = true;
+        RobotsSnapshot out;
+        for (size_t t = 0; t < live.size() && same; ++t) {
+            same = replay.Seek(replay.FirstTurn() + (int)t, out) && sameSnapshot(out, live[t]);
+        }
+        // cutting the recording back and playing on must give the same file
+        if (same) {
+            int cut = (int)live.size() / 2;
+            writer.Truncate(live[cut]);
+            for (size_t t = cut + 1; t < live.size(); ++t) {
+                live[t].Apply(match);
+                writer.Record(match);
+            }
+            same = writer.Finish() == bytes;
+        }
+        RobotsRng rng;
+        rng.Seed(seed);
+        std::vector<int> targets(seeks);
+        for (int &t : targets) t = replay.FirstTurn() + (int)(rng.Next() % live.size());
+        start = std::chrono::steady_clock::now();
+        for (int t : targets) replay.Seek(t, out);
+        double seekUs = msSince(start) * 1000.0 / seeks;
+
+        printf("%6d %12zu %9.1f%% %10.0f %10.2f %12.2f %6s\n", interval, fileSize, 100.0 * fileSize / textBytes,
+               (double)fileSize / live.size(), recordMs, seekUs, same ? "yes" : "NO");
+        fflush(stdout);
+        if (!same) return 2;
+    }
+    return 0;
+}
+
+// every BotState field, VM cycle statistics included, and the RNG
+static bool sameMeteredState(const Arena &a, const Arena &b)
+{
+    if (a.bots.size() != b.bots.size() || a.rng.state != b.rng.state || a.signals != b.signals) return false;
+    for (size_t i = 0; i < a.bots.size(); ++i) {
+        const auto &x = a.bots[i], &y = b.bots[i];
+        if (x.x != y.x || x.y != y.y || x.dir != y.dir || x.hp != y.hp || x.last_hp != y.last_hp ||
+            x.damaged_last_turn != y.damaged_last_turn || x.alive != y.alive || x.cooldown != y.cooldown ||
+            x.scan_dist != y.scan_dist || x.scan_dir != y.scan_dir || x.signal != y.signal || x.cycles != y.cycles ||
+            x.max_cycles != y.max_cycles || x.total_cycles != y.total_cycles || x.turns_run != y.turns_run ||
+            x.cycle_outs != y.cycle_outs) return false;
+    }
+    return true;
+}
+
+static int benchNative(int argc, char** argv)
+{
+    int size = 256;
+    int count = 1000;
+    int turns = 40;
+    int matches = 20000;
+    uint64_t seed = 1;
+    ArenaConfig base;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--size") && i + 1 < argc) {
+            size = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--bots") && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            turns = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            matches = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--budget") && i + 1 < argc) {
+            base.instructionBudget = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (size <= 0 || count <= 0 || turns <= 0 || matches <= 0 || (long long)count > (long long)size * size) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // the three rosters: macro bots, native programs interpreted, native programs compiled
+    std::vector<RobotEntry> rosters[3] = {ClassRoster(), NativeClassRoster(false), NativeClassRoster(true)};
+
+    printf("%-12s %6s %6s %8s %8s\n", "bot", "cost", "native", "p-code", "same");
+    bool same = true;
+    for (size_t b = 0; b < rosters[0].size(); ++b) {
+        std::unique_ptr<RobotBase> macro = rosters[0][b].make(), native = rosters[2][b].make();
+        macro->SetupRobot();
+        native->SetupRobot();
+        bool code = macro->code == native->code && macro->script_cost == native->script_cost;
+        printf("%-12s %6d %6d %8zu %8s\n", macro->name.c_str(), macro->script_cost, native->script_cost,
+               macro->code.size(), code ? "yes" : "NO");
+        same = same && code;
+    }
+    if (!same) return 2;
+
+    printf("%-12s %10s %10s %10s %10s %12s %12s %12s %6s\n", "workload", "bot-turns", "macro ms", "interp ms",
+           "native ms", "macro ns/bt", "interp", "native", "same");
+    auto report = [](const char* label, long long botTurns, const double ms[3], bool same) {
+        printf("%-12s %10lld %10.2f %10.2f %10.2f %12.1f %12.1f %12.1f %6s\n", label, botTurns, ms[0], ms[1], ms[2],
+               ms[0] * 1e6 / botTurns, ms[1] * 1e6 / botTurns, ms[2] * 1e6 / botTurns, same ? "yes" : "NO");
+        fflush(stdout);
+    };
+
+    // ladder: many class-size matches, whole matches timed
+    {
+        double ms[3] = {0.0, 0.0, 0.0};
+        long long botTurns = 0;
+        for (int m = 0; m < matches && same; ++m) {
+            RobotsMatch played[3];
+            for (int k = 0; k < 3; ++k) {
+                auto start = std::chrono::steady_clock::now();
+                played[k].Setup(rosters[k], seed + m, base);
+                played[k].Play();
+                ms[k] += msSince(start);
+            }
+            for (auto &b : played[0].arena.bots) botTurns += b.turns_run;
+            same = sameMeteredState(played[0].arena, played[1].arena) && sameMeteredState(played[0].arena, played[2].arena) &&
+                   played[0].turn == played[2].turn;
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "%d matches", matches);
+        report(label, botTurns, ms, same);
+    }
+
+    // large board: bot turns only, compared after every turn
+    if (same) {
+        ArenaConfig config = base;
+        config.width = config.height = size;
+        config.botCount = count;
+        config.maxTurns = turns;
+        RobotsMatch played[3];
+        for (int k = 0; k < 3; ++k) played[k].Setup(rosters[k], seed, config);
+
+        double ms[3] = {0.0, 0.0, 0.0};
+        long long botTurns = 0;
+        for (int t = 1; t <= turns && same; ++t) {
+            for (int k = 0; k < 3; ++k) {
+                RobotsMatch &match = played[k];
+                match.arena.StartTurn();
+                auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < match.bots.size(); ++i) {
+                    if (!match.arena.bots[i].alive) continue;
+                    match.bots[i]->Run(t);
+                    if (k == 0) botTurns++;
+                }
+                ms[k] += msSince(start);
+            }
+            same = sameMeteredState(played[0].arena, played[1].arena) && sameMeteredState(played[0].arena, played[2].arena);
+        }
+        char label[32];
+        snprintf(label, sizeof(label), "%d bots", count);
+        report(label, botTurns, ms, same);
+    }
+    return same ? 0 : 2;
+}
+
+static int benchBundle(int argc, char** argv)
+{
+    int entrants = 4096;
+    int matches = 20000;
+    int turns = 20;
+    uint64_t seed = 1;
+    std::string path = "bench.rbb";
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--entrants") && i + 1 < argc) {
+            entrants = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            matches = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            turns = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (entrants < 2 || matches <= 0 || turns <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // entrant k is class bot k % 4 under its own name
+    std::vector<RobotEntry> classes = ClassRoster(), roster;
+    for (int k = 0; k < entrants; ++k) {
+        const RobotEntry &c = classes[k % classes.size()];
+        roster.push_back(RobotEntry{ c.name + "#" + std::to_string(k), c.make });
+    }
+
+    std::string error;
+    auto start = std::chrono::steady_clock::now();
+    if (!WriteBotBundle(path, roster, &error)) {
+        printf("%s\n", error.c_str());
+        return 1;
+    }
+    double writeMs = msSince(start);
+    RobotsBundle bundle;
+    start = std::chrono::steady_clock::now();
+    if (!bundle.Open(path, &error)) {
+        printf("%s\n", error.c_str());
+        return 1;
+    }
+    std::vector<RobotEntry> bundled = bundle.Roster();
+    double openMs = msSince(start);
+    printf("%d entrants: bundle written in %.2f ms, mapped and lowered in %.2f ms\n", bundle.Size(), writeMs, openMs);
+
+    ArenaConfig config;
+    config.maxTurns = turns;
+    RobotsRng pick;
+    pick.Seed(seed);
+    const std::vector<RobotEntry>* rosters[2] = {&roster, &bundled};
+    double setupMs[2] = {0.0, 0.0}, playMs[2] = {0.0, 0.0};
+    bool same = true;
+    for (int m = 0; m < matches && same; ++m) {
+        int a = pick.Range(0, entrants - 1), b = pick.Range(0, entrants - 2);
+        if (b >= a) b++;
+        RobotsMatch played[2];
+        for (int k = 0; k < 2; ++k) {
+            std::vector<std::unique_ptr<RobotBase>> pair;
+            start = std::chrono::steady_clock::now();
+            pair.emplace_back((*rosters[k])[a].make());
+            pair.emplace_back((*rosters[k])[b].make());
+            played[k].Setup(std::move(pair), seed + m, config);
+            setupMs[k] += msSince(start);
+            start = std::chrono::steady_clock::now();
+            played[k].Play();
+            playMs[k] += msSince(start);
+        }
+        same = sameMeteredState(played[0].arena, played[1].arena) && played[0].turn == played[1].turn;
+    }
+
+    printf("%-8s %12s %12s %14s %12s\n", "roster", "setup ms", "play ms", "setup us/match", "setup share");
+    const char* labels[2] = {"classes", "bundle"};
+    for (int k = 0; k < 2; ++k) {
+        printf("%-8s %12.2f %12.2f %14.2f %11.1f%%\n", labels[k], setupMs[k], playMs[k], setupMs[k] * 1e3 / matches,
+               100.0 * setupMs[k] / (setupMs[k] + playMs[k]));
+    }
+    printf("%d matches of %d turns, same: %s\n", matches, turns, same ? "yes" : "NO");
+    return same ? 0 : 2;
+}
+
+static bool sameProgram(const RobotProgram &a, const RobotProgram &b)
+{
+    if (a.scriptCost != b.scriptCost || a.instrs.size() != b.instrs.size()) return false;
+    for (size_t i = 0; i < a.instrs.size(); ++i) {
+        const RobotInstr &x = a.instrs[i], &y = b.instrs[i];
+        if (x.op != y.op || x.arg != y.arg || x.target != y.target) return false;
+    }
+    return true;
+}
+
+static int benchScript(int argc, char** argv)
+{
+    int entrants = 500;
+    uint64_t seed = 1;
+    std::string dir = "bench_bots";
+
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--entrants") && i + 1 < argc) {
+            entrants = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (entrants < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    // random, valid statement trees; nothing is played
+    EvolveOptions options;
+    options.population = entrants;
+    options.seed = seed;
+    options.threads = 1;
+    RobotsEvolution evolution(ClassRoster(), options);
+    evolution.Initialize();
+
+    std::error_code ec;
+    std::string cache = dir + "/.botcache";
+    std::filesystem::remove_all(dir, ec);
+    std::filesystem::create_directories(dir, ec);
+    std::vector<std::shared_ptr<const RobotProgram>> expected;
+    char name[32];
+    for (int k = 0; k < entrants; ++k) {
+        const RobotGenome &genome = evolution.Population()[k].genome;
+        snprintf(name, sizeof(name), "bot%05d", k);
+        FILE* f = fopen((dir + "/" + name + ".bot").c_str(), "w");
+        if (!f || fputs(BotScriptSource(genome, name).c_str(), f) < 0) {
+            printf("cannot write %s\n", dir.c_str());
+            if (f) fclose(f);
+            return 1;
+        }
+        fclose(f);
+        GenomeBot bot(std::make_shared<const RobotGenome>(genome), name);
+        bot.SetupRobot();
+        expected.push_back(bot.program);
+    }
+
+    // out-of-range operands: a direction past the tables, and a negative
+    // MOVE that would pay for six ATTACKs
+    const char* const invalid[] = {
+        "NAME(Far)\nTURN(1000000);\nMOVE(1);\n",
+        "NAME(Behind)\nIF_ENEMY(-5000000) {\n    ATTACK(0);\n}\n",
+        "NAME(Cheap)\nMOVE(-10);\nATTACK(0); ATTACK(1); ATTACK(2);\nATTACK(3); ATTACK(4); ATTACK(5);\nSCAN(); SCAN();\n",
+    };
+    for (const char* source : invalid) {
+        BotScript script;
+        std::string error;
+        bool rejected = !ParseBotScript(source, script, &error) && error.compare(0, 5, "line ") == 0;
+        if (!rejected) {
+            printf("accepted an invalid script:\n%s", source);
+            return 2;
+        }
+        printf("rejected: %s\n", error.c_str());
+    }
+
+    printf("%-12s %10s %8s %8s %8s %12s %6s\n", "load", "ms", "parsed", "cached", "pruned", "us/script", "same");
+    bool same = true;
+    // `parsed` scripts must compile from text and the rest map from the
+    // cache; Prune() must then drop `pruned` stale entries
+    auto run = [&](const char* label, const std::string &cacheDir, int parsed, int pruned) {
+        RobotsScriptLoader loader(cacheDir);
+        std::vector<RobotEntry> roster;
+        std::string error;
+        auto start = std::chrono::steady_clock::now();
+        if (!loader.LoadDirectory(dir, roster, &error)) {
+            printf("%s\n", error.c_str());
+            same = false;
+            return;
+        }
+        double ms = msSince(start);
+        int removed = loader.Prune();
+        bool ok = (int)roster.size() == entrants && loader.Parsed() == parsed &&
+                  loader.CacheHits() == (cacheDir.empty() ? 0 : entrants - parsed) && removed == pruned;
+        for (int k = 0; k < entrants && ok; ++k) {
+            std::unique_ptr<RobotBase> bot = roster[k].make();
+            bot->SetupRobot();
+            snprintf(name, sizeof(name), "bot%05d", k);
+            ok = bot->name == name && sameProgram(*bot->program, *expected[k]);
+        }
+        printf("%-12s %10.2f %8d %8d %8d %12.2f %6s\n", label, ms, loader.Parsed(), loader.CacheHits(), removed, ms * 1e3 / entrants,
+               ok ? "yes" : "NO");
+        same = same && ok;
+    };
+    run("no cache", "", entrants, 0);
+    if (same) run("cold cache", cache, entrants, 0);
+    if (same) run("warm cache", cache, 0, 0);
+    // a comment changes the text but not the program: only that script
+    // recompiles, and its old entry is the one pruned
+    FILE* f = fopen((dir + "/bot00000.bot").c_str(), "a");
+    if (!f || fputs("// edited\n", f) < 0) {
+        printf("cannot write %s\n", dir.c_str());
+        if (f) fclose(f);
+        return 1;
+    }
+    fclose(f);
+    if (same) run("one edited", cache, 1, 1);
+    return same ? 0 : 2;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "scale")) {
+        return benchScale(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "scan")) {
+        return benchScan(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "signal")) {
+        return benchSignal(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "flow")) {
+        return benchFlow(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "vm")) {
+        return benchVm(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "replay")) {
+        return benchReplay(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "native")) {
+        return benchNative(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "bundle")) {
+        return benchBundle(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "script")) {
+        return benchScript(argc, argv);
+    }
+    usage(argv[0]);
+    return 1;
+}
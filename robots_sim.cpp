@@ -0,0 +1,825 @@
+// robots_sim: headless Robots match runner
+//
+// Plays full matches with the class roster (no window, no ImGui) and reports
+// the winner of each match and overall throughput.
+//
+//   robots_sim [-n matches] [-v] [--seed S] [--budget N] [--cycles] [--simultaneous] [--profile file]
+//   robots_sim tournament [-r rounds] [-j threads] [--no-pairs] [--no-ffa] [--seed S] [--analytics file]
+//                         [--bundle file] [--scripts dir] [--script-cache dir]
+//   robots_sim bundle [-o file]
+//   robots_sim stats <file>
+//   robots_sim record [-o file] [-k K] [--seed S] [--simultaneous]
+//   robots_sim replay <file> [--turn T] [--resume]
+//   robots_sim evolve [-p population] [-g generations] [-r rounds] [-j threads] [--seed S]
+//                     [--no-ffa] [--checkpoint file] [--resume file] [--export file] [--name N]
+//   robots_sim compare <A> <B> [-j threads] [--seed S] [--elo0 E] [--elo1 E] [--alpha P] [--beta P]
+//                      [--max-games N] [--pool dir]
+//
+// Match m of a run is played with seed S + m, so any single match can be
+// replayed with `robots_sim -n 1 --seed <its seed>`. --simultaneous plays
+// every turn as simultaneous moves (see Arena::BeginPlanning). --profile
+// runs every bot on the profiling interpreter (see RobotProfile), prints each
+// bot's hot path and writes the counters, summed over all matches, as CSV.
+//
+// record plays one match and writes a binary replay (see RobotsReplay.h);
+// replay prints the state at any turn of one, and --resume restarts the
+// match from that turn with the class roster and checks it plays out as
+// recorded.
+//
+// tournament --analytics writes every bot's per-match statistics to a
+// columnar file (see RobotsAnalytics.h); stats scans one and sums them per
+// bot.
+//
+// bundle compiles the class roster into a bot bundle (see RobotsBundle.h);
+// tournament --bundle plays the bots of one instead of the class roster.
+// tournament --scripts plays every .bot script in a directory (see
+// RobotsScript.h, and resources/bots for the class roster as scripts),
+// caching the compiled scripts in <dir>/.botcache unless told otherwise
+// (that default cache drops the entries of edited and deleted scripts).
+//
+// evolve breeds bots against the class roster (see RobotsEvolve.h),
+// checkpointing every generation, and prints the best one as SetupRobot()
+// source.
+//
+// compare decides whether bot version A is stronger than B with a
+// sequential probability ratio test (see RobotsCompare.h), playing both
+// against the class roster (or the .bot scripts of --pool) only until the
+// answer is in. A and B are class bot names or .bot script paths.
+
+#include "classes/RobotsAnalytics.h"
+#include "classes/RobotsBundle.h"
+#include "classes/RobotsCompare.h"
+#include "classes/RobotsEvolve.h"
+#include "classes/RobotsMatch.h"
+#include "classes/RobotsNative.h"
+#include "classes/RobotsReplay.h"
+#include "classes/RobotsScript.h"
+#include "classes/RobotsTournament.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+static void usage(const char* exe)
+{
+    printf("usage: %s [-n matches] [-v] [--seed S] [--budget N] [--cycles] [--simultaneous] [--profile file]\n", exe);
+    printf("       %s tournament [-r rounds] [-j threads] [--no-pairs] [--no-ffa] [--seed S] [--analytics file]\n", exe);
+    printf("              [--bundle file] [--scripts dir] [--script-cache dir]\n");
+    printf("       %s bundle [-o file]\n", exe);
+    printf("       %s stats <file>\n", exe);
+    printf("       %s record [-o file] [-k K] [--seed S] [--simultaneous]\n", exe);
+    printf("       %s replay <file> [--turn T] [--resume]\n", exe);
+    printf("       %s evolve [-p population] [-g generations] [-r rounds] [-j threads] [--seed S]\n", exe);
+    printf("              [--no-ffa] [--checkpoint file] [--resume file] [--export file] [--name N]\n");
+    printf("       %s compare <A> <B> [-j threads] [--seed S] [--elo0 E] [--elo1 E] [--alpha P] [--beta P]\n", exe);
+    printf("              [--max-games N] [--pool dir]\n");
+    printf("  -n N        number of matches to play (default 100)\n");
+    printf("  --seed S    seed of the first match (default: random)\n");
+    printf("  -v          print the result of every match\n");
+    printf("  --budget N  VM instructions per bot turn, 0 = unmetered (default %d)\n", MAX_TURN_INSTRUCTIONS);
+    printf("  --cycles    print per-bot VM cycle statistics\n");
+    printf("  --simultaneous  bots plan on the same board, then all moves resolve at once\n");
+    printf("  --profile FILE  profile every bot's VM and write the counters as CSV\n");
+    printf("  -r N        matches per tournament lineup (default 100)\n");
+    printf("  -j N        worker threads (default: one per core)\n");
+    printf("  --no-pairs  skip the 1v1 pairings\n");
+    printf("  --no-ffa    skip the free-for-all lineup\n");
+    printf("  --analytics FILE  write per-bot match statistics as a columnar file\n");
+    printf("  --bundle FILE     play the bots of a bot bundle\n");
+    printf("  --scripts DIR     play the .bot scripts in a directory\n");
+    printf("  --script-cache DIR  compiled script cache (default <scripts>/.botcache)\n");
+    printf("  -o FILE     replay file to write (default match.rbr)\n");
+    printf("              (bundle: bundle file to write, default bots.rbb)\n");
+    printf("  -k K        turns between replay keyframes (default 16)\n");
+    printf("  --turn T    replay turn to show (default: last)\n");
+    printf("  --resume    continue the match from --turn and compare with the recording\n");
+    printf("              (evolve: continue from a checkpoint file)\n");
+    printf("  -p N        evolve population size (default 64)\n");
+    printf("  -g N        generations to breed (default 30)\n");
+    printf("              (evolve: -r is games per lineup, default 4)\n");
+    printf("  --checkpoint FILE  write the population after every generation (default evolve.ckpt)\n");
+    printf("  --export FILE      write the best bot as C++ source\n");
+    printf("  --name N    struct name of the exported bot (default Evolved)\n");
+    printf("  A, B        bot versions to compare: class bot names or .bot script paths\n");
+    printf("  --elo0 E    H0: A is E Elo stronger than B (default 0)\n");
+    printf("  --elo1 E    H1: A is E Elo stronger than B (default 10)\n");
+    printf("  --alpha P   false positive rate (default 0.05)\n");
+    printf("  --beta P    false negative rate (default 0.05)\n");
+    printf("  --max-games N  give up undecided after N games per version (default 20000)\n");
+    printf("  --pool DIR  play against the .bot scripts in DIR instead of the class roster\n");
+}
+
+static void printRecords(const char* title, const std::vector<std::string> &names, const std::vector<TournamentRecord> &records)
+{
+    printf("%s\n", title);
+    printf("  %-10s %7s %7s %7s %7s %7s\n", "bot", "played", "wins", "draws", "losses", "win%");
+    for (size_t i = 0; i < names.size(); ++i) {
+        const TournamentRecord &r = records[i];
+        if (r.played == 0) continue;
+        printf("  %-10s %7d %7d %7d %7d %6.1f%%\n", names[i].c_str(), r.played, r.wins, r.draws, r.losses, 100.0 * r.wins / r.played);
+    }
+}
+
+static int runTournament(int argc, char** argv)
+{
+    TournamentOptions options;
+    bool seeded = false;
+    const char* analyticsPath = nullptr;
+    const char* bundlePath = nullptr;
+    std::string scriptDir, scriptCache;
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            options.rounds = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            options.threads = (unsigned)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--no-pairs")) {
+            options.pairings = false;
+        } else if (!strcmp(argv[i], "--no-ffa")) {
+            options.freeForAll = false;
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 0);
+            seeded = true;
+        } else if (!strcmp(argv[i], "--analytics") && i + 1 < argc) {
+            analyticsPath = argv[++i];
+        } else if (!strcmp(argv[i], "--bundle") && i + 1 < argc) {
+            bundlePath = argv[++i];
+        } else if (!strcmp(argv[i], "--scripts") && i + 1 < argc) {
+            scriptDir = argv[++i];
+        } else if (!strcmp(argv[i], "--script-cache") && i + 1 < argc) {
+            scriptCache = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.rounds <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (!seeded) {
+        options.seed = RandomSeed();
+    }
+
+    std::vector<RobotEntry> roster = ClassRoster();
+    if (bundlePath) {
+        RobotsBundle bundle;
+        std::string error;
+        if (!bundle.Open(bundlePath, &error)) {
+            printf("%s: %s\n", bundlePath, error.c_str());
+            return 1;
+        }
+        roster = bundle.Roster();
+    } else if (!scriptDir.empty()) {
+        RobotsScriptLoader loader(scriptCache.empty() ? scriptDir + "/.botcache" : scriptCache);
+        std::string error;
+        roster.clear();
+        auto start = std::chrono::steady_clock::now();
+        if (!loader.LoadDirectory(scriptDir, roster, &error)) {
+            printf("%s\n", error.c_str());
+            return 1;
+        }
+        printf("loaded %zu scripts (%d parsed, %d cached) in %.2f ms\n", roster.size(), loader.Parsed(), loader.CacheHits(),
+               std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        // the default cache holds this directory's scripts only; one given
+        // with --script-cache may be shared, so it is left alone
+        if (scriptCache.empty()) loader.Prune();
+    }
+    if (roster.size() < 2) {
+        printf("a tournament needs at least two bots\n");
+        return 1;
+    }
+
+    RobotsAnalyticsWriter analytics;
+    if (analyticsPath) {
+        std::string error;
+        if (!analytics.Open(analyticsPath, &error)) {
+            printf("%s\n", error.c_str());
+            return 1;
+        }
+        options.analytics = &analytics;
+    }
+
+    TournamentResult result = RunTournament(roster, options);
+    if (analyticsPath) {
+        if (!analytics.Close()) {
+            printf("cannot write %s\n", analyticsPath);
+            return 1;
+        }
+        printf("wrote %llu rows to %s\n", (unsigned long long)analytics.Rows(), analyticsPath);
+    }
+
+    if (options.pairings) {
+        printRecords("1v1 pairings:", result.names, result.pairings);
+        printf("head to head (wins-draws-losses, row vs column):\n  %-10s", "");
+        for (auto &name : result.names) printf(" %12s", name.c_str());
+        printf("\n");
+        for (size_t a = 0; a < result.names.size(); ++a) {
+            printf("  %-10s", result.names[a].c_str());
+            for (size_t b = 0; b < result.names.size(); ++b) {
+                const TournamentRecord &r = result.headToHead[a][b];
+                char cell[32];
+                if (a == b) snprintf(cell, sizeof(cell), "-");
+                else snprintf(cell, sizeof(cell), "%d-%d-%d", r.wins, r.draws, r.losses);
+                printf(" %12s", cell);
+            }
+            printf("\n");
+        }
+    }
+    if (options.freeForAll) {
+        printRecords("free-for-all:", result.names, result.freeForAll);
+    }
+    printf("%d matches, %lld turns in %.3f s on %u threads (seed %llu)\n", result.matches, result.turns, result.seconds, result.threads, (unsigned long long)result.seed);
+    printf("%.1f matches/sec\n", result.seconds > 0.0 ? result.matches / result.seconds : 0.0);
+    return 0;
+}
+
+static int writeBundle(int argc, char** argv)
+{
+    std::string path = "bots.rbb";
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    std::string error;
+    if (!WriteBotBundle(path, ClassRoster(), &error)) {
+        printf("%s\n", error.c_str());
+        return 1;
+    }
+    RobotsBundle bundle;
+    if (!bundle.Open(path, &error)) {
+        printf("%s: %s\n", path.c_str(), error.c_str());
+        return 1;
+    }
+    for (int i = 0; i < bundle.Size(); ++i) {
+        printf("%-10s cost %3d  %3zu p-code ints\n", bundle.Name(i).c_str(), bundle.ScriptCost(i), bundle.Code(i).size());
+    }
+    printf("wrote %d bots to %s\n", bundle.Size(), path.c_str());
+    return 0;
+}
+
+// the ops a bot spends its turns on, with branch outcomes, and where the
+// time inside Arena goes
+static void printProfile(const std::string &name, const RobotProfile &p)
+{
+    printf("%s: %lld turns, %.0f ns/turn\n", name.c_str(), p.turns, p.turns ? (double)p.turnNs / p.turns : 0.0);
+    std::vector<int> ops;
+    for (int op = 0; op < VM_OP_COUNT; ++op) {
+        if (p.ops[op].count) ops.push_back(op);
+    }
+    std::sort(ops.begin(), ops.end(), [&](int a, int b) { return p.ops[a].count > p.ops[b].count; });
+    printf("  %-16s %12s %8s %8s\n", "op", "executed", "/turn", "taken%");
+    for (int op : ops) {
+        const RobotProfile::Op &o = p.ops[op];
+        long long branches = o.taken + o.notTaken;
+        char taken[16] = "";
+        if (branches) snprintf(taken, sizeof(taken), "%.1f", 100.0 * o.taken / branches);
+        printf("  %-16s %12lld %8.2f %8s\n", RobotVmOpName(op), o.count, p.turns ? (double)o.count / p.turns : 0.0, taken);
+    }
+    printf("  %-16s %12s %8s %8s\n", "Arena call", "calls", "ns/call", "time%");
+    for (int call = 0; call < ARENA_CALL_COUNT; ++call) {
+        const RobotProfile::Call &c = p.calls[call];
+        if (!c.count) continue;
+        printf("  %-16s %12lld %8.0f %8.1f\n", RobotArenaCallName(call), c.count, (double)c.ns / c.count,
+               p.turnNs ? 100.0 * c.ns / p.turnNs : 0.0);
+    }
+}
+
+static int showStats(int argc, char** argv)
+{
+    if (argc != 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    RobotsAnalyticsReader reader;
+    std::string error;
+    if (!reader.Open(argv[2], &error)) {
+        printf("%s: %s\n", argv[2], error.c_str());
+        return 1;
+    }
+
+    // per bot name: rows, wins, draws, then the summed counters
+    static const int SUMMED[] = { STAT_DAMAGE_DEALT, STAT_DAMAGE_TAKEN, STAT_SHOTS_FIRED, STAT_SHOTS_MISSED,
+                                  STAT_KILLS, STAT_TILES_MOVED, STAT_TURNS_SURVIVED, STAT_SIGNALS };
+    const int summed = (int)(sizeof(SUMMED) / sizeof(SUMMED[0]));
+    uint32_t mask = 1u << STAT_NAME | 1u << STAT_RESULT;
+    for (int c : SUMMED) mask |= 1u << c;
+    struct Totals { long long rows = 0, wins = 0, draws = 0; std::vector<long long> sums; };
+    std::vector<Totals> totals;
+
+    auto start = std::chrono::steady_clock::now();
+    RobotsStatChunk chunk;
+    long long rows = 0;
+    int chunks = 0;
+    while (reader.Next(chunk, mask)) {
+        chunks++;
+        rows += chunk.rows;
+        if (totals.size() < reader.Names().size()) {
+            totals.resize(reader.Names().size());
+            for (Totals &t : totals) t.sums.resize(summed);
+        }
+        const std::vector<int64_t> &name = chunk.columns[STAT_NAME], &result = chunk.columns[STAT_RESULT];
+        for (int r = 0; r < chunk.rows; ++r) {
+            Totals &t = totals[name[r]];
+            t.rows++;
+            t.wins += result[r] > 0;
+            t.draws += result[r] == 0;
+        }
+        for (int k = 0; k < summed; ++k) {
+            const std::vector<int64_t> &column = chunk.columns[SUMMED[k]];
+            for (int r = 0; r < chunk.rows; ++r) totals[name[r]].sums[k] += column[r];
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!reader.Error().empty()) printf("%s: %s, stopped after %d chunks\n", argv[2], reader.Error().c_str(), chunks);
+
+    printf("%lld rows in %d chunks, scanned in %.3f s (%.1f M rows/s)\n", rows, chunks, seconds,
+           seconds > 0.0 ? rows / seconds / 1e6 : 0.0);
+    printf("  %-10s %9s %6s %6s", "bot", "matches", "win%", "draw%");
+    for (int c : SUMMED) printf(" %14s", RobotsStatColumnName(c));
+    printf("\n");
+    for (size_t i = 0; i < totals.size(); ++i) {
+        const Totals &t = totals[i];
+        if (!t.rows) continue;
+        printf("  %-10s %9lld %5.1f%% %5.1f%%", reader.Names()[i].c_str(), t.rows, 100.0 * t.wins / t.rows, 100.0 * t.draws / t.rows);
+        for (int k = 0; k < summed; ++k) printf(" %14.2f", (double)t.sums[k] / t.rows);
+        printf("\n");
+    }
+    printf("(counters are per match)\n");
+    return 0;
+}
+
+static int recordMatch(int argc, char** argv)
+{
+    std::string path = "match.rbr";
+    int interval = 16;
+    uint64_t seed = RandomSeed();
+    ArenaConfig config;
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            path = argv[++i];
+        } else if (!strcmp(argv[i], "-k") && i + 1 < argc) {
+            interval = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--simultaneous")) {
+            config.simultaneous = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (interval <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    RobotsMatch match;
+    match.Setup(MakeClassBots(), seed, config);
+    RobotsReplayWriter writer;
+    writer.Begin(match, interval);
+    while (match.Step()) {
+        writer.Record(match);
+    }
+    writer.Record(match);   // final (stopped) state
+
+    if (!writer.Save(path)) {
+        printf("cannot write %s\n", path.c_str());
+        return 1;
+    }
+    int winner = match.Winner();
+    printf("seed %llu: %s after %d turns\n", (unsigned long long)seed,
+           winner >= 0 ? (match.bots[winner]->name + " wins").c_str() : "draw", match.TurnsPlayed());
+    printf("wrote %s: turns %d..%d, %zu bytes\n", path.c_str(), writer.FirstTurn(), writer.LastTurn(), writer.Finish().size());
+    return 0;
+}
+
+static void printSnapshot(const RobotsReplay &replay, const RobotsSnapshot &s)
+{
+    printf("turn %d%s, %zu signals\n", s.turn, s.running ? "" : " (over)", s.signals.size());
+    printf("  %-10s %5s %5s %4s %4s %3s %8s %6s\n", "bot", "x", "y", "dir", "hp", "cd", "scan", "alive");
+    for (size_t i = 0; i < s.bots.size(); ++i) {
+        const Arena::BotState &b = s.bots[i];
+        printf("  %-10s %5d %5d %4d %4d %3d %4d/%-3d %6s\n", replay.Names()[i].c_str(), b.x, b.y, b.dir, b.hp, b.cooldown,
+               b.scan_dist, b.scan_dir, b.alive ? "yes" : "no");
+    }
+}
+
+static bool sameSnapshot(const RobotsSnapshot &a, const RobotsSnapshot &b)
+{
+    if (a.turn != b.turn || a.running != b.running || a.bots.size() != b.bots.size() || a.signals != b.signals ||
+        a.rng.state != b.rng.state || a.rng.inc != b.rng.inc) return false;
+    for (size_t i = 0; i < a.bots.size(); ++i) {
+        const Arena::BotState &x = a.bots[i], &y = b.bots[i];
+        if (x.x != y.x || x.y != y.y || x.dir != y.dir || x.hp != y.hp || x.last_hp != y.last_hp ||
+            x.damaged_last_turn != y.damaged_last_turn || x.alive != y.alive || x.scan_dist != y.scan_dist ||
+            x.scan_dir != y.scan_dir || x.cooldown != y.cooldown || x.signal != y.signal) return false;
+    }
+    return true;
+}
+
+static int showReplay(int argc, char** argv)
+{
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char* path = argv[2];
+    int turn = -1;
+    bool resume = false;
+    for (int i = 3; i < argc; ++i) {
+        if (!strcmp(argv[i], "--turn") && i + 1 < argc) {
+            turn = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--resume")) {
+            resume = true;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    RobotsReplay replay;
+    std::string error;
+    if (!replay.Load(path, &error)) {
+        printf("%s: %s\n", path, error.c_str());
+        return 1;
+    }
+    if (turn < 0) turn = replay.LastTurn();
+    printf("%s: seed %llu, %zu bots on %dx%d%s, turns %d..%d, keyframe every %d, %zu bytes\n", path,
+           (unsigned long long)replay.Seed(), replay.Names().size(), replay.Config().width, replay.Config().height,
+           replay.Config().simultaneous ? " (simultaneous)" : "",
+           replay.FirstTurn(), replay.LastTurn(), replay.KeyframeInterval(), replay.Bytes());
+
+    RobotsSnapshot snapshot;
+    if (!replay.Seek(turn, snapshot)) {
+        printf("cannot seek to turn %d\n", turn);
+        return 1;
+    }
+    printSnapshot(replay, snapshot);
+    if (!resume) return 0;
+
+    // rebuild the roster by name and continue from the snapshot
+    std::vector<std::unique_ptr<RobotBase>> bots;
+    std::vector<RobotEntry> roster = ClassRoster();
+    for (auto &name : replay.Names()) {
+        auto entry = std::find_if(roster.begin(), roster.end(), [&](const RobotEntry &e) { return e.name == name; });
+        if (entry == roster.end()) {
+            printf("bot %s is not in the class roster\n", name.c_str());
+            return 1;
+        }
+        bots.push_back(entry->make());
+    }
+    RobotsMatch match;
+    match.Setup(std::move(bots), replay.Seed(), replay.Config());
+    snapshot.Apply(match);
+    bool same = true;
+    RobotsSnapshot live, recorded;
+    while (same && match.Step()) {
+        live.Capture(match);
+        same = replay.Seek(match.turn, recorded) && sameSnapshot(live, recorded);
+    }
+    if (same && match.turn <= replay.LastTurn()) {
+        live.Capture(match);
+        same = replay.Seek(match.turn, recorded) && sameSnapshot(live, recorded);
+    }
+    printf("resumed from turn %d: %s at turn %d\n", turn, same ? "matches the recording" : "DIVERGES from the recording", match.turn);
+    return same ? 0 : 2;
+}
+
+static int runEvolution(int argc, char** argv)
+{
+    EvolveOptions options;
+    int generations = 30;
+    bool seeded = false;
+    std::string checkpoint = "evolve.ckpt", resume, exportPath, name = "Evolved";
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            options.population = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            generations = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            options.rounds = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            options.threads = (unsigned)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 0);
+            seeded = true;
+        } else if (!strcmp(argv[i], "--no-ffa")) {
+            options.freeForAll = false;
+        } else if (!strcmp(argv[i], "--checkpoint") && i + 1 < argc) {
+            checkpoint = argv[++i];
+        } else if (!strcmp(argv[i], "--resume") && i + 1 < argc) {
+            resume = argv[++i];
+        } else if (!strcmp(argv[i], "--export") && i + 1 < argc) {
+            exportPath = argv[++i];
+        } else if (!strcmp(argv[i], "--name") && i + 1 < argc) {
+            name = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.population < 2 || options.rounds <= 0 || generations < 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!seeded) {
+        options.seed = RandomSeed();
+    }
+
+    // the class roster as compiled programs: same play, cheaper matches
+    RobotsEvolution evolution(NativeClassRoster(), options);
+    std::string error;
+    auto report = [&](double seconds) {
+        const EvolveIndividual &best = evolution.Population().front();
+        double mean = 0.0;
+        for (auto &ind : evolution.Population()) mean += ind.fitness;
+        mean /= evolution.Population().size();
+        int games = best.wins + best.draws + best.losses;
+        printf("gen %3d  best %6.3f  mean %6.3f  best W-D-L %d-%d-%d (%.0f%% wins)  cost %2d  nodes %2d  %.0f matches/s\n",
+               evolution.Generation(), best.fitness, mean, best.wins, best.draws, best.losses,
+               games ? 100.0 * best.wins / games : 0.0, GenomeCost(best.genome), GenomeNodes(best.genome),
+               seconds > 0.0 ? evolution.MatchesPerIndividual() * evolution.Population().size() / seconds : 0.0);
+        fflush(stdout);
+        if (!evolution.SaveCheckpoint(checkpoint, &error)) {
+            printf("%s\n", error.c_str());
+        }
+    };
+    auto evaluate = [&]() {
+        auto start = std::chrono::steady_clock::now();
+        evolution.Evaluate();
+        report(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    };
+
+    if (!resume.empty()) {
+        // a checkpoint holds an evaluated generation; carry on by breeding
+        if (!evolution.LoadCheckpoint(resume, &error)) {
+            printf("%s: %s\n", resume.c_str(), error.c_str());
+            return 1;
+        }
+        printf("resumed %s at generation %d (seed %llu)\n", resume.c_str(), evolution.Generation(),
+               (unsigned long long)evolution.Options().seed);
+    } else {
+        printf("evolving %d bots, %d games each per generation, on %u threads (seed %llu)\n",
+               evolution.Options().population, evolution.MatchesPerIndividual(), evolution.Threads(),
+               (unsigned long long)evolution.Options().seed);
+        evolution.Initialize();
+        evaluate();
+    }
+    while (evolution.Generation() < generations) {
+        evolution.Breed();
+        evaluate();
+    }
+
+    std::string source = GenomeSource(evolution.Population().front().genome, name);
+    printf("\n%s", source.c_str());
+    printf("%lld matches played\n", evolution.MatchesPlayed());
+    if (!exportPath.empty()) {
+        FILE* f = fopen(exportPath.c_str(), "w");
+        if (!f || fputs(source.c_str(), f) < 0) {
+            printf("cannot write %s\n", exportPath.c_str());
+            if (f) fclose(f);
+            return 1;
+        }
+        fclose(f);
+    }
+    return 0;
+}
+
+// a bot version: a class bot by name, else a .bot script (not cached: the
+// version under test is the one being edited)
+static bool resolveVersion(const std::string &spec, RobotEntry &entry, std::string &error)
+{
+    for (auto &e : NativeClassRoster()) {
+        if (e.name == spec) {
+            entry = e;
+            return true;
+        }
+    }
+    if (!std::filesystem::exists(spec)) {
+        error = spec + ": neither a class bot nor a .bot script";
+        return false;
+    }
+    RobotsScriptLoader loader;
+    return loader.Load(spec, entry, &error);
+}
+
+static int runComparison(int argc, char** argv)
+{
+    CompareOptions options;
+    bool seeded = false;
+    std::vector<std::string> versions;
+    std::string poolDir;
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+            options.threads = (unsigned)atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            options.seed = strtoull(argv[++i], nullptr, 0);
+            seeded = true;
+        } else if (!strcmp(argv[i], "--elo0") && i + 1 < argc) {
+            options.elo0 = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--elo1") && i + 1 < argc) {
+            options.elo1 = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--alpha") && i + 1 < argc) {
+            options.alpha = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--beta") && i + 1 < argc) {
+            options.beta = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "--max-games") && i + 1 < argc) {
+            options.maxGames = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--pool") && i + 1 < argc) {
+            poolDir = argv[++i];
+        } else if (argv[i][0] != '-') {
+            versions.push_back(argv[i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (versions.size() != 2 || options.maxGames <= 0 || options.elo1 <= options.elo0 ||
+        options.alpha <= 0.0 || options.alpha >= 1.0 || options.beta <= 0.0 || options.beta >= 1.0) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (!seeded) {
+        options.seed = RandomSeed();
+    }
+
+    RobotEntry a, b;
+    std::string error;
+    if (!resolveVersion(versions[0], a, error) || !resolveVersion(versions[1], b, error)) {
+        printf("%s\n", error.c_str());
+        return 1;
+    }
+    std::vector<RobotEntry> pool = NativeClassRoster();
+    if (!poolDir.empty()) {
+        RobotsScriptLoader loader(poolDir + "/.botcache");
+        pool.clear();
+        if (!loader.LoadDirectory(poolDir, pool, &error)) {
+            printf("%s\n", error.c_str());
+            return 1;
+        }
+        loader.Prune();
+        if (pool.empty()) {
+            printf("no .bot scripts in %s\n", poolDir.c_str());
+            return 1;
+        }
+    }
+
+    printf("A: %s (%s)\nB: %s (%s)\npool:", versions[0].c_str(), a.name.c_str(), versions[1].c_str(), b.name.c_str());
+    for (auto &entry : pool) printf(" %s", entry.name.c_str());
+    printf("\nSPRT elo0 %g elo1 %g alpha %g beta %g\n", options.elo0, options.elo1, options.alpha, options.beta);
+    fflush(stdout);
+
+    CompareResult result = RunComparison(a, b, pool, options);
+    printRecords("against the pool:", {"A", "B"}, {result.a, result.b});
+    printf("LLR %.2f (bounds %.2f, %.2f)\n", result.llr, result.lower, result.upper);
+    if (result.verdict > 0) printf("H1 accepted: A is stronger than B\n");
+    else if (result.verdict < 0) printf("H0 accepted: A is not stronger than B\n");
+    else printf("undecided after %d games\n", result.games);
+    printf("Elo A - B: %+.1f +- %.1f (95%%)\n", result.elo, result.eloError);
+    printf("%d games, %d matches (%d played) in %.3f s on %u threads (seed %llu)\n", result.games, result.matches,
+           result.matchesPlayed, result.seconds, result.threads, (unsigned long long)result.seed);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && !strcmp(argv[1], "tournament")) {
+        return runTournament(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "bundle")) {
+        return writeBundle(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "stats")) {
+        return showStats(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "record")) {
+        return recordMatch(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "replay")) {
+        return showReplay(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "evolve")) {
+        return runEvolution(argc, argv);
+    }
+    if (argc > 1 && !strcmp(argv[1], "compare")) {
+        return runComparison(argc, argv);
+    }
+
+    int matches = 100;
+    bool verbose = false;
+    bool cycles = false;
+    uint64_t seed = RandomSeed();
+    ArenaConfig config;
+    const char* profilePath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            matches = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-v")) {
+            verbose = true;
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else if (!strcmp(argv[i], "--budget") && i + 1 < argc) {
+            config.instructionBudget = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--cycles")) {
+            cycles = true;
+        } else if (!strcmp(argv[i], "--simultaneous")) {
+            config.simultaneous = true;
+        } else if (!strcmp(argv[i], "--profile") && i + 1 < argc) {
+            profilePath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (matches <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<std::string> names;
+    std::vector<int> wins;
+    std::vector<Arena::BotState> totals;    // cycle stats summed per roster slot
+    std::vector<RobotProfile> profiles;     // likewise, with --profile
+    int draws = 0;
+    long long turns = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int m = 0; m < matches; ++m) {
+        RobotsMatch match;
+        match.profiling = profilePath != nullptr;
+        match.Setup(MakeClassBots(), seed + m, config);
+        if (names.empty()) {
+            for (auto &bot : match.bots) names.push_back(bot->name);
+            wins.assign(names.size(), 0);
+            totals.assign(names.size(), Arena::BotState());
+            if (profilePath) profiles.assign(names.size(), RobotProfile());
+        }
+        match.Play();
+        for (size_t i = 0; i < profiles.size(); ++i) {
+            profiles[i].Add(*match.bots[i]->profile);
+        }
+        turns += match.TurnsPlayed();
+        for (size_t i = 0; i < names.size(); ++i) {
+            const Arena::BotState &b = match.arena.bots[i];
+            totals[i].total_cycles += b.total_cycles;
+            totals[i].turns_run += b.turns_run;
+            totals[i].max_cycles = std::max(totals[i].max_cycles, b.max_cycles);
+            totals[i].cycle_outs += b.cycle_outs;
+        }
+
+        int winner = match.Winner();
+        if (winner >= 0) {
+            wins[winner]++;
+        } else {
+            draws++;
+        }
+        if (verbose) {
+            if (winner >= 0) {
+                printf("match %d (seed %llu): %s wins on turn %d\n", m + 1, (unsigned long long)match.seed, names[winner].c_str(), match.turn);
+            } else {
+                printf("match %d (seed %llu): draw, %d bots standing\n", m + 1, (unsigned long long)match.seed, match.AliveCount());
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("%d matches, %lld turns in %.3f s (seed %llu)\n", matches, turns, seconds, (unsigned long long)seed);
+    for (size_t i = 0; i < names.size(); ++i) {
+        printf("  %-10s %6d wins (%5.1f%%)\n", names[i].c_str(), wins[i], 100.0 * wins[i] / matches);
+    }
+    printf("  %-10s %6d      (%5.1f%%)\n", "draws", draws, 100.0 * draws / matches);
+    if (cycles) {
+        printf("VM cycles per bot turn (budget %d):\n", config.instructionBudget);
+        printf("  %-10s %10s %8s %8s %12s\n", "bot", "turns", "avg", "max", "out of budget");
+        for (size_t i = 0; i < names.size(); ++i) {
+            const Arena::BotState &t = totals[i];
+            printf("  %-10s %10d %8.2f %8d %12d\n", names[i].c_str(), t.turns_run,
+                   t.turns_run ? (double)t.total_cycles / t.turns_run : 0.0, t.max_cycles, t.cycle_outs);
+        }
+    }
+    printf("%.1f matches/sec\n", seconds > 0.0 ? matches / seconds : 0.0);
+    if (profilePath) {
+        std::string csv = ROBOT_PROFILE_CSV_HEADER;
+        for (size_t i = 0; i < names.size(); ++i) {
+            printProfile(names[i], profiles[i]);
+            AppendProfileCsv(csv, names[i], profiles[i]);
+        }
+        FILE* f = fopen(profilePath, "wb");
+        if (!f || fwrite(csv.data(), 1, csv.size(), f) != csv.size()) {
+            if (f) fclose(f);
+            printf("cannot write %s\n", profilePath);
+            return 1;
+        }
+        fclose(f);
+        printf("wrote %s\n", profilePath);
+    }
+    return 0;
+}